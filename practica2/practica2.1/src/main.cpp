@@ -7,38 +7,438 @@
  */
 
 #include <Arduino.h>
+#include <math.h>
+#include <string.h>
+
+/**
+ * Generador pseudoaleatorio xoshiro256** de 64 bits.
+ * Es rápido, reproducible a partir de una semilla explícita y permite saltar 2^128
+ * valores hacia delante, de modo que cada trabajador de una simulación puede usar
+ * una subsecuencia propia que no se solapa con las de los demás.
+ */
+class Xoshiro256 {
+private:
+  uint64_t state[4]; // Estado interno del generador
+  
+  // Rotación a la izquierda de 64 bits
+  static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+  
+  // Paso del generador SplitMix64, usado para expandir la semilla al estado completo
+  static uint64_t splitMix64(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  
+  // Avanza el estado según el polinomio de salto indicado
+  void applyJump(const uint64_t *polynomial) {
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+      for (int b = 0; b < 64; b++) {
+        if (polynomial[i] & ((uint64_t)1 << b)) {
+          s0 ^= state[0];
+          s1 ^= state[1];
+          s2 ^= state[2];
+          s3 ^= state[3];
+        }
+        next();
+      }
+    }
+    state[0] = s0;
+    state[1] = s1;
+    state[2] = s2;
+    state[3] = s3;
+  }
+  
+public:
+  /**
+   * Constructor de la clase
+   * @param seed Semilla de 64 bits
+   */
+  Xoshiro256(uint64_t seed = 0) {
+    setSeed(seed);
+  }
+  
+  /**
+   * Reinicia el generador a partir de una semilla de 64 bits
+   * @param seed Semilla
+   */
+  void setSeed(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+      state[i] = splitMix64(seed);
+    }
+  }
+  
+  /**
+   * Genera el siguiente valor de 64 bits
+   * @return Valor aleatorio de 64 bits
+   */
+  uint64_t next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+    
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    
+    return result;
+  }
+  
+  /**
+   * Genera el siguiente valor de 32 bits (los 32 bits altos, que son los de mejor calidad)
+   * @return Valor aleatorio de 32 bits
+   */
+  uint32_t next32() {
+    return (uint32_t)(next() >> 32);
+  }
+  
+  /**
+   * Avanza el generador 2^128 valores. Llamándolo k veces sobre la misma semilla
+   * se obtiene la k-ésima subsecuencia independiente.
+   */
+  void jump() {
+    static const uint64_t JUMP[4] = {
+      0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    applyJump(JUMP);
+  }
+  
+  /**
+   * Avanza el generador 2^192 valores, para repartir subsecuencias entre grupos de trabajadores.
+   */
+  void longJump() {
+    static const uint64_t LONG_JUMP[4] = {
+      0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL
+    };
+    applyJump(LONG_JUMP);
+  }
+};
+
+/**
+ * Clase que simula un canal ruidoso para comunicaciones binarias.
+ * Permite configurar el porcentaje de ruido que se introducirá en los mensajes.
+ *
+ * Dispone de dos modos de funcionamiento:
+ * - MODE_BIT: genera un número aleatorio por cada bit y lo compara con f a resolución completa.
+ * - MODE_WORD: construye máscaras de error de 64 bits de una vez y las aplica con XOR
+ *   palabra a palabra. Para f bajas se usa muestreo geométrico de huecos (se salta
+ *   directamente al siguiente bit erróneo) y para f altas se construye la máscara
+ *   bit a bit como combinación AND/OR de palabras aleatorias (Bernoulli por palabra).
+ *
+ * Los números aleatorios salen de un generador xoshiro256** propio del canal, con semilla
+ * explícita de 64 bits y selección de subsecuencia, para poder repetir exactamente una
+ * simulación y repartirla entre varios trabajadores sin solapamiento.
+ */
+class NoisyChannel {
+public:
+  // Modos de generación de errores
+  enum Mode {
+    MODE_BIT,  // Un número aleatorio por bit
+    MODE_WORD  // Máscaras de error de 64 bits
+  };
+  
+private:
+  // Por debajo de esta probabilidad compensa el muestreo geométrico de huecos
+  static constexpr float GAP_SAMPLING_MAX_NOISE = 0.1;
+  // Bits de precisión con los que se representa f en el modo Bernoulli por palabra
+  static const int BERNOULLI_PRECISION = 24;
+  
+  float noisePercentage; // Porcentaje de ruido (entre 0 y 1)
+  Mode mode;             // Modo de generación de errores
+  
+  Xoshiro256 generator;  // Generador pseudoaleatorio del canal
+  uint64_t seed;         // Semilla con la que se inicializó el generador
+  uint64_t bitThreshold; // f escalada a 2^32, para comparar en el modo MODE_BIT
+  
+  // Estado del generador de máscaras (modo MODE_WORD)
+  bool useGapSampling;         // true si se usa muestreo geométrico de huecos
+  float inverseLogNoNoise;     // 1 / ln(1 - f), para muestrear la longitud de los huecos
+  uint32_t bitsToNextError;    // Bits correctos que faltan hasta el siguiente error
+  uint32_t bernoulliThreshold; // f cuantizada con BERNOULLI_PRECISION bits
+  int bernoulliFirstRound;     // Primer bit no nulo de bernoulliThreshold
+  
+  // Obtiene una semilla de la fuente de entropía del hardware (solo al construir el canal)
+  static uint64_t hardwareSeed() {
+#if defined(ESP32)
+    return ((uint64_t)esp_random() << 32) | esp_random();
+#else
+    return ((uint64_t)analogRead(0) << 32) ^ micros();
+#endif
+  }
+  
+  // Devuelve 32 bits aleatorios
+  uint32_t nextRandom32() {
+    return generator.next32();
+  }
+  
+  // Devuelve 64 bits aleatorios
+  uint64_t nextRandom64() {
+    return generator.next();
+  }
+  
+  // Muestrea el número de bits correctos antes del siguiente error (distribución geométrica)
+  uint32_t sampleGap() {
+    // u en (0, 1], nunca 0 para que el logaritmo esté definido
+    float u = (nextRandom32() + 1.0f) * (1.0f / 4294967296.0f);
+    float gap = logf(u) * inverseLogNoNoise;
+    if (gap >= 4294967295.0f) {
+      return 0xFFFFFFFF;
+    }
+    return (uint32_t)gap;
+  }
+  
+  // Recalcula los parámetros del generador de máscaras a partir de noisePercentage
+  void updateMaskParameters() {
+    bitThreshold = (uint64_t)((double)noisePercentage * 4294967296.0);
+    
+    useGapSampling = noisePercentage > 0 && noisePercentage < GAP_SAMPLING_MAX_NOISE;
+    if (useGapSampling) {
+      inverseLogNoNoise = 1.0f / logf(1.0f - noisePercentage);
+      bitsToNextError = sampleGap();
+    }
+    
+    bernoulliThreshold = (uint32_t)(noisePercentage * (1 << BERNOULLI_PRECISION) + 0.5f);
+    bernoulliFirstRound = 0;
+    if (bernoulliThreshold != 0) {
+      // Los bits nulos menos significativos no aportan nada (0 AND r = 0)
+      while (((bernoulliThreshold >> bernoulliFirstRound) & 1) == 0) {
+        bernoulliFirstRound++;
+      }
+    }
+  }
+  
+  // Envío bit a bit (un número aleatorio por bit)
+  int sendPacketBitwise(unsigned char *input, unsigned char *output, int length) {
+    int flippedBits = 0;
+    
+    // Recorrer cada byte del vector de entrada
+    for (int i = 0; i < length; i++) {
+      // Inicializar el byte de salida con el valor del byte de entrada
+      output[i] = input[i];
+      
+      // Procesar cada bit del byte actual
+      for (int j = 0; j < 8; j++) {
+        // Si el número aleatorio de 32 bits es menor que f * 2^32,
+        // invertir el bit correspondiente en el byte de salida
+        if (nextRandom32() < bitThreshold) {
+          // Invertir el bit j-ésimo usando XOR con una máscara
+          output[i] ^= (1 << j);
+          flippedBits++;
+        }
+      }
+    }
+    return flippedBits;
+  }
+  
+  // Envío palabra a palabra con máscaras de error de 64 bits
+  int sendPacketWordwise(unsigned char *input, unsigned char *output, int length) {
+    int flippedBits = 0;
+    int i = 0;
+    
+    // Aplicar una máscara por cada bloque completo de 8 bytes
+    for (; i + 8 <= length; i += 8) {
+      uint64_t word;
+      uint64_t mask = nextErrorMask();
+      memcpy(&word, input + i, 8);
+      word ^= mask;
+      memcpy(output + i, &word, 8);
+      flippedBits += __builtin_popcountll(mask);
+    }
+    
+    // Bytes restantes: se usan los bytes bajos de una última máscara
+    if (i < length) {
+      uint64_t mask = nextErrorMask();
+      for (; i < length; i++) {
+        unsigned char byteMask = mask & 0xFF;
+        output[i] = input[i] ^ byteMask;
+        flippedBits += __builtin_popcount(byteMask);
+        mask >>= 8;
+      }
+    }
+    return flippedBits;
+  }
+  
+public:
+  /**
+   * Constructor de la clase NoisyChannel.
+   * La semilla se toma de la fuente de entropía del hardware.
+   * @param noise Porcentaje de ruido que se introducirá en los mensajes (entre 0 y 1)
+   * @param channelMode Modo de generación de errores (por defecto, máscaras por palabra)
+   */
+  NoisyChannel(float noise, Mode channelMode = MODE_WORD) {
+    // Asegurar que el porcentaje de ruido esté entre 0 y 1
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    mode = channelMode;
+    setSeed(hardwareSeed());
+  }
+  
+  /**
+   * Constructor de la clase NoisyChannel con semilla explícita (simulaciones reproducibles).
+   * @param noise Porcentaje de ruido que se introducirá en los mensajes (entre 0 y 1)
+   * @param channelSeed Semilla de 64 bits del generador
+   * @param channelMode Modo de generación de errores (por defecto, máscaras por palabra)
+   */
+  NoisyChannel(float noise, uint64_t channelSeed, Mode channelMode = MODE_WORD) {
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    mode = channelMode;
+    setSeed(channelSeed);
+  }
+  
+  /**
+   * Envía un paquete a través del canal ruidoso.
+   * La entrada y la salida pueden ser el mismo vector.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
+   */
+  int sendPacket(unsigned char *input, unsigned char *output, int length) {
+    if (mode == MODE_BIT) {
+      return sendPacketBitwise(input, output, length);
+    }
+    return sendPacketWordwise(input, output, length);
+  }
+  
+  /**
+   * Recibe un paquete a través del canal ruidoso.
+   * Esta función es idéntica a sendPacket, ya que el canal es simétrico.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
+   */
+  int receivePacket(unsigned char *input, unsigned char *output, int length) {
+    // En un canal simétrico, enviar y recibir son operaciones equivalentes
+    return sendPacket(input, output, length);
+  }
+  
+  /**
+   * Genera una máscara de error de 64 bits donde cada bit vale 1 con probabilidad f.
+   * Es la base del modo MODE_WORD y la usan también otros canales para construir sus errores.
+   * @return Máscara de error
+   */
+  uint64_t nextErrorMask() {
+    if (useGapSampling) {
+      // Saltar directamente de un error al siguiente
+      uint64_t mask = 0;
+      while (bitsToNextError < 64) {
+        mask |= (uint64_t)1 << bitsToNextError;
+        uint32_t gap = sampleGap();
+        bitsToNextError = (gap > 0xFFFFFFFF - 65) ? 0xFFFFFFFF : bitsToNextError + 1 + gap;
+      }
+      bitsToNextError -= 64;
+      return mask;
+    }
+    
+    if (bernoulliThreshold == 0) {
+      return 0;
+    }
+    if (bernoulliThreshold >= (1u << BERNOULLI_PRECISION)) {
+      return ~(uint64_t)0;
+    }
+    
+    // Comparar cada bit con la expansión binaria de f, del bit menos significativo al más
+    // significativo: un 1 en f combina con OR y un 0 combina con AND
+    uint64_t mask = 0;
+    for (int k = bernoulliFirstRound; k < BERNOULLI_PRECISION; k++) {
+      if ((bernoulliThreshold >> k) & 1) {
+        mask |= nextRandom64();
+      } else {
+        mask &= nextRandom64();
+      }
+    }
+    return mask;
+  }
+  
+  /**
+   * Obtiene el porcentaje de ruido configurado en el canal.
+   * @return Porcentaje de ruido (entre 0 y 1)
+   */
+  float getNoisePercentage() {
+    return noisePercentage;
+  }
+  
+  /**
+   * Establece un nuevo porcentaje de ruido para el canal.
+   * @param noise Nuevo porcentaje de ruido (entre 0 y 1)
+   */
+  void setNoisePercentage(float noise) {
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    updateMaskParameters();
+  }
+  
+  /**
+   * Obtiene el modo de generación de errores.
+   * @return Modo actual
+   */
+  Mode getMode() {
+    return mode;
+  }
+  
+  /**
+   * Establece el modo de generación de errores.
+   * @param channelMode Nuevo modo
+   */
+  void setMode(Mode channelMode) {
+    mode = channelMode;
+  }
+  
+  /**
+   * Reinicia el generador del canal con una semilla explícita.
+   * Dos canales con la misma semilla y configuración producen exactamente los mismos errores.
+   * @param channelSeed Semilla de 64 bits
+   */
+  void setSeed(uint64_t channelSeed) {
+    seed = channelSeed;
+    generator.setSeed(seed);
+    updateMaskParameters();
+  }
+  
+  /**
+   * Obtiene la semilla con la que se inicializó el generador.
+   * @return Semilla de 64 bits
+   */
+  uint64_t getSeed() {
+    return seed;
+  }
+  
+  /**
+   * Selecciona la subsecuencia aleatoria número streamIndex de la semilla actual.
+   * Cada subsecuencia está separada 2^128 valores de la siguiente, así que trabajadores
+   * con la misma semilla e índices distintos nunca comparten números aleatorios.
+   * @param streamIndex Índice de la subsecuencia (0 es la secuencia original)
+   */
+  void selectStream(int streamIndex) {
+    generator.setSeed(seed);
+    for (int i = 0; i < streamIndex; i++) {
+      generator.jump();
+    }
+    updateMaskParameters();
+  }
+};
 
 /**
  * Función que simula un canal ruidoso.
+ * Mantiene un único canal entre llamadas, de modo que la semilla solo se inicializa una vez.
  * @param in Vector binario de entrada empaquetado en unsigned char
  * @param out Vector binario de salida empaquetado en unsigned char
  * @param l Longitud del vector en bytes
  * @param f Probabilidad de que un bit cambie de valor (entre 0 y 1)
+ * @return Número de bits invertidos por el canal
  */
-void noisyChannel(unsigned char *in, unsigned char *out, int l, float f) {
-  // Inicializar la semilla para la generación de números aleatorios
-  // En una implementación real, esto debería hacerse solo una vez al inicio del programa
-  randomSeed(analogRead(0));
-  
-  // Recorrer cada byte del vector de entrada
-  for (int i = 0; i < l; i++) {
-    // Inicializar el byte de salida con el valor del byte de entrada
-    out[i] = in[i];
-    
-    // Procesar cada bit del byte actual
-    for (int j = 0; j < 8; j++) {
-      // Generar un número aleatorio entre 0 y 1
-      float r = random(0, 100) / 100.0;
-      
-      // Si el número aleatorio es menor que la probabilidad de error f,
-      // invertir el bit correspondiente en el byte de salida
-      if (r < f) {
-        // Invertir el bit j-ésimo usando XOR con una máscara
-        // La máscara tiene un 1 en la posición j y 0 en las demás posiciones
-        out[i] ^= (1 << j);
-      }
-    }
+int noisyChannel(unsigned char *in, unsigned char *out, int l, float f) {
+  static NoisyChannel channel(f);
+  
+  if (channel.getNoisePercentage() != f) {
+    channel.setNoisePercentage(f);
   }
+  return channel.sendPacket(in, out, l);
 }
 
 // Función para imprimir un vector de bytes en formato binario
@@ -69,23 +469,12 @@ void setup() {
   Serial.println("Vector de entrada:");
   printBinaryVector(input, length);
   
-  // Aplicar el canal ruidoso
-  noisyChannel(input, output, length, errorProb);
+  // Aplicar el canal ruidoso (devuelve los bits que han cambiado)
+  int changedBits = noisyChannel(input, output, length, errorProb);
   
   Serial.println("Vector de salida (después del canal ruidoso):");
   printBinaryVector(output, length);
   
-  // Contar bits que han cambiado
-  int changedBits = 0;
-  for (int i = 0; i < length; i++) {
-    unsigned char diff = input[i] ^ output[i]; // XOR para detectar bits diferentes
-    for (int j = 0; j < 8; j++) {
-      if ((diff >> j) & 1) {
-        changedBits++;
-      }
-    }
-  }
-  
   Serial.print("Bits cambiados: ");
   Serial.print(changedBits);
   Serial.print(" de ");
@@ -7,6 +7,14 @@
  * la robustez adicional que proporciona la repetición.
  */
 #include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#if defined(ESP32) && __has_include(<esp_rom_crc.h>)
+#include <esp_rom_crc.h>
+#define CRC_USE_ROM 1 // CrcFrame usa las rutinas de CRC de la ROM en lugar de las tablas
+#else
+#define CRC_USE_ROM 0
+#endif
 
 // Función auxiliar global para imprimir un vector de bytes en formato binario
 void printBinaryVector(unsigned char *vec, int length) {
@@ -20,18 +28,551 @@ void printBinaryVector(unsigned char *vec, int length) {
   Serial.println();
 }
 
+#ifndef DECODER_STATS
+#define DECODER_STATS 0 // Con -DDECODER_STATS=1 los decodificadores llevan contadores internos
+#endif
+
+#if DECODER_STATS
+#include <atomic>
+
+/**
+ * Contadores de un decodificador con una copia por hilo. Cada hilo incrementa solo su
+ * ranura, alineada a una línea de caché para que dos hilos no escriban en la misma línea,
+ * así que el decodificador no necesita operaciones atómicas; al leer se suman todas las
+ * ranuras. Counters tiene que ser un struct de enteros con un método merge.
+ * Pueden decodificar a la vez como máximo MAX_THREADS hilos.
+ */
+template <class Counters>
+class DecoderStats {
+public:
+  static const int MAX_THREADS = 8; // Número de ranuras
+  static const int CACHE_LINE = 64; // Tamaño de una línea de caché en bytes
+  
+private:
+  // Contadores de un hilo, en sus propias líneas de caché
+  struct alignas(CACHE_LINE) Slot {
+    Counters counters;
+  };
+  
+  Slot slots[MAX_THREADS];
+  
+  /**
+   * Método auxiliar que asigna una ranura a cada hilo la primera vez que la pide
+   * @return Índice de la ranura del hilo actual
+   */
+  static int threadSlot() {
+    static std::atomic<int> nextSlot(0);
+    static thread_local int slot = nextSlot.fetch_add(1) % MAX_THREADS;
+    return slot;
+  }
+  
+public:
+  /**
+   * Constructor de la clase: todos los contadores empiezan a 0
+   */
+  DecoderStats() : slots() {
+  }
+  
+  /**
+   * Método para obtener los contadores del hilo actual
+   * @return Contadores de la ranura del hilo
+   */
+  Counters &local() {
+    return slots[threadSlot()].counters;
+  }
+  
+  /**
+   * Método para obtener la suma de los contadores de todos los hilos
+   * @return Contadores acumulados
+   */
+  Counters read() const {
+    Counters total = Counters();
+    for (int i = 0; i < MAX_THREADS; i++) {
+      total.merge(slots[i].counters);
+    }
+    return total;
+  }
+  
+  /**
+   * Método para poner a 0 todos los contadores
+   */
+  void reset() {
+    for (int i = 0; i < MAX_THREADS; i++) {
+      slots[i] = Slot();
+    }
+  }
+};
+#endif
+
+/**
+ * Contadores del decodificador Hamming (ver DECODER_STATS): un histograma de las palabras
+ * código decodificadas. Los 3 bits bajos del índice son el síndrome de la parte (7,4) y el
+ * bit 3 indica que se ha corregido un error: en (7,4) siempre que el síndrome no es nulo;
+ * en SECDED cuando falla la paridad global. Así, los índices 1 a 7 son las palabras con
+ * dos errores detectados en modo SECDED.
+ */
+struct HammingCounters {
+  uint32_t syndromes[16]; // Palabras código decodificadas por índice
+  
+  /**
+   * Método para acumular los contadores de otro hilo
+   * @param other Contadores a sumar
+   */
+  void merge(const HammingCounters &other) {
+    for (int i = 0; i < 16; i++) {
+      syndromes[i] += other.syndromes[i];
+    }
+  }
+  
+  /**
+   * Método para obtener el número de palabras código decodificadas
+   * @return Número de palabras código
+   */
+  uint32_t getCodewords() const {
+    uint32_t total = 0;
+    for (int i = 0; i < 16; i++) {
+      total += syndromes[i];
+    }
+    return total;
+  }
+  
+  /**
+   * Método para obtener el número de errores corregidos
+   * @return Palabras código en las que se ha corregido un bit
+   */
+  uint32_t getCorrections() const {
+    uint32_t total = 0;
+    for (int i = 8; i < 16; i++) {
+      total += syndromes[i];
+    }
+    return total;
+  }
+  
+  /**
+   * Método para obtener el número de palabras con dos errores detectados (solo SECDED)
+   * @return Palabras código no corregibles
+   */
+  uint32_t getUncorrectable() const {
+    return getCodewords() - getCorrections() - syndromes[0];
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal. Una palabra llega sin errores
+   * detectables con probabilidad (1 - f)^n, así que f = 1 - (limpias / total)^(1/n).
+   * @param wordBits Bits de cada palabra código (7 en (7,4), 8 en SECDED)
+   * @return Estimación de f (0 si no hay palabras)
+   */
+  float estimateErrorRate(int wordBits) const {
+    uint32_t codewords = getCodewords();
+    if (codewords == 0) {
+      return 0;
+    }
+    return 1 - powf((float)syndromes[0] / codewords, 1.0f / wordBits);
+  }
+};
+
 /**
  * Clase que implementa un codificador y decodificador Hamming (7,4).
  * Permite codificar mensajes usando el código Hamming (7,4) y decodificarlos
  * con capacidad de corrección de errores de un solo bit.
+ *
+ * Tiene dos modos:
+ * - MODE_7_4: Hamming (7,4); las palabras de 7 bits se empaquetan seguidas.
+ * - MODE_SECDED_8_4: Hamming extendido (8,4) con un bit de paridad global por palabra.
+ *   Cada palabra ocupa exactamente un byte, corrige un error y detecta dos (SECDED).
  */
 class HammingCode {
+public:
+  // Variante del código
+  enum Mode {
+    MODE_7_4,       // Hamming (7,4)
+    MODE_SECDED_8_4 // Hamming extendido (8,4): corrige un error y detecta dos
+  };
+  
+  // Bit que marca en SECDED_DECODE_TABLE las palabras con dos errores (no corregibles)
+  static const unsigned char UNCORRECTABLE = 0x10;
+  
+private:
+  Mode mode; // Variante del código
+#if DECODER_STATS
+  DecoderStats<HammingCounters> stats; // Histograma de síndromes, uno por hilo
+#endif
+  
+  // Palabra con la que trabaja el decodificador por bit slicing. En el ordenador, si hay
+  // AVX2, es un vector de 4 palabras de 64 bits (256 palabras código por paso); en el
+  // ESP32 es una palabra de 64 bits (64 palabras código por paso)
+#if defined(__AVX2__)
+  typedef uint64_t SliceWord __attribute__((vector_size(32)));
+#else
+  typedef uint64_t SliceWord;
+#endif
+  static const int SLICE_LANES = sizeof(SliceWord) / sizeof(uint64_t);
+  static const int SLICE_CODEWORDS = 64 * SLICE_LANES;
+  
+  // Palabra código de 7 bits de cada nibble (p1 en el bit 6, d4 en el bit 0)
+  static constexpr unsigned char ENCODE_TABLE[16] = {
+    0x00, 0x69, 0x2A, 0x43, 0x4C, 0x25, 0x66, 0x0F, 0x70, 0x19, 0x5A, 0x33, 0x3C, 0x55, 0x16, 0x7F
+  };
+  
+  // Nibble corregido de cada palabra de 7 bits recibida: se calcula el síndrome, se invierte
+  // el bit que indica y se extraen d1, d2, d3 y d4
+  static constexpr unsigned char DECODE_TABLE[128] = {
+    0x0, 0x0, 0x0, 0x3, 0x0, 0x5, 0xE, 0x7, 0x0, 0x9, 0x2, 0x7, 0x4, 0x7, 0x7, 0x7,
+    0x0, 0x9, 0xE, 0xB, 0xE, 0xD, 0xE, 0xE, 0x9, 0x9, 0xA, 0x9, 0xC, 0x9, 0xE, 0x7,
+    0x0, 0x5, 0x2, 0xB, 0x5, 0x5, 0x6, 0x5, 0x2, 0x1, 0x2, 0x2, 0xC, 0x5, 0x2, 0x7,
+    0x8, 0xB, 0xB, 0xB, 0xC, 0x5, 0xE, 0xB, 0xC, 0x9, 0x2, 0xB, 0xC, 0xC, 0xC, 0xF,
+    0x0, 0x3, 0x3, 0x3, 0x4, 0xD, 0x6, 0x3, 0x4, 0x1, 0xA, 0x3, 0x4, 0x4, 0x4, 0x7,
+    0x8, 0xD, 0xA, 0x3, 0xD, 0xD, 0xE, 0xD, 0xA, 0x9, 0xA, 0xA, 0x4, 0xD, 0xA, 0xF,
+    0x8, 0x1, 0x6, 0x3, 0x6, 0x5, 0x6, 0x6, 0x1, 0x1, 0x2, 0x1, 0x4, 0x1, 0x6, 0xF,
+    0x8, 0x8, 0x8, 0xB, 0x8, 0xD, 0x6, 0xF, 0x8, 0x1, 0xA, 0xF, 0xC, 0xF, 0xF, 0xF
+  };
+  
+  // Palabra código de 8 bits del modo SECDED de cada nibble: la palabra de Hamming (7,4)
+  // en los bits 7 a 1 y el bit de paridad global p0 en el bit 0
+  static constexpr unsigned char SECDED_ENCODE_TABLE[16] = {
+    0x00, 0xD2, 0x55, 0x87, 0x99, 0x4B, 0xCC, 0x1E, 0xE1, 0x33, 0xB4, 0x66, 0x78, 0xAA, 0x2D, 0xFF
+  };
+  
+  // Nibble decodificado de cada palabra de 8 bits recibida en modo SECDED. Si la paridad
+  // global falla hay un único error y se corrige con el síndrome; si la paridad es correcta
+  // pero el síndrome no es nulo hay dos errores, no se corrige nada y se activa el bit
+  // UNCORRECTABLE
+  static constexpr unsigned char SECDED_DECODE_TABLE[256] = {
+    0x00, 0x00, 0x00, 0x11, 0x00, 0x12, 0x13, 0x03, 0x00, 0x14, 0x15, 0x05, 0x16, 0x0E, 0x07, 0x17,
+    0x00, 0x10, 0x11, 0x09, 0x12, 0x02, 0x07, 0x13, 0x14, 0x04, 0x07, 0x15, 0x07, 0x16, 0x07, 0x07,
+    0x00, 0x18, 0x19, 0x09, 0x1A, 0x0E, 0x0B, 0x1B, 0x1C, 0x0E, 0x0D, 0x1D, 0x0E, 0x0E, 0x1F, 0x0E,
+    0x18, 0x09, 0x09, 0x09, 0x0A, 0x1A, 0x1B, 0x09, 0x0C, 0x1C, 0x1D, 0x09, 0x1E, 0x0E, 0x07, 0x1F,
+    0x00, 0x10, 0x11, 0x05, 0x12, 0x02, 0x0B, 0x13, 0x14, 0x05, 0x05, 0x05, 0x06, 0x16, 0x17, 0x05,
+    0x10, 0x02, 0x01, 0x11, 0x02, 0x02, 0x13, 0x02, 0x0C, 0x14, 0x15, 0x05, 0x16, 0x02, 0x07, 0x17,
+    0x18, 0x08, 0x0B, 0x19, 0x0B, 0x1A, 0x0B, 0x0B, 0x0C, 0x1C, 0x1D, 0x05, 0x1E, 0x0E, 0x0B, 0x1F,
+    0x0C, 0x18, 0x19, 0x09, 0x1A, 0x02, 0x0B, 0x1B, 0x0C, 0x0C, 0x0C, 0x1D, 0x0C, 0x1E, 0x1F, 0x0F,
+    0x00, 0x10, 0x11, 0x03, 0x12, 0x03, 0x03, 0x03, 0x14, 0x04, 0x0D, 0x15, 0x06, 0x16, 0x17, 0x03,
+    0x10, 0x04, 0x01, 0x11, 0x0A, 0x12, 0x13, 0x03, 0x04, 0x04, 0x15, 0x04, 0x16, 0x04, 0x07, 0x17,
+    0x18, 0x08, 0x0D, 0x19, 0x0A, 0x1A, 0x1B, 0x03, 0x0D, 0x1C, 0x0D, 0x0D, 0x1E, 0x0E, 0x0D, 0x1F,
+    0x0A, 0x18, 0x19, 0x09, 0x0A, 0x0A, 0x0A, 0x1B, 0x1C, 0x04, 0x0D, 0x1D, 0x0A, 0x1E, 0x1F, 0x0F,
+    0x10, 0x08, 0x01, 0x11, 0x06, 0x12, 0x13, 0x03, 0x06, 0x14, 0x15, 0x05, 0x06, 0x06, 0x06, 0x17,
+    0x01, 0x10, 0x01, 0x01, 0x12, 0x02, 0x01, 0x13, 0x14, 0x04, 0x01, 0x15, 0x06, 0x16, 0x17, 0x0F,
+    0x08, 0x08, 0x19, 0x08, 0x1A, 0x08, 0x0B, 0x1B, 0x1C, 0x08, 0x0D, 0x1D, 0x06, 0x1E, 0x1F, 0x0F,
+    0x18, 0x08, 0x01, 0x19, 0x0A, 0x1A, 0x1B, 0x0F, 0x0C, 0x1C, 0x1D, 0x0F, 0x1E, 0x0F, 0x0F, 0x0F
+  };
+  
+  /**
+   * Método auxiliar que calcula el síndrome de una palabra código de 7 bits
+   * @param word Palabra código con p1 en el bit 6 y d4 en el bit 0 (p1, p2, d1, p3, d2, d3, d4)
+   * @return Posición del error (1 a 7) o 0 si la palabra es válida
+   */
+  static unsigned char codewordSyndrome(unsigned char word) {
+    unsigned char s1 = ((word >> 6) ^ (word >> 4) ^ (word >> 2) ^ word) & 1; // p1 ^ d1 ^ d2 ^ d4
+    unsigned char s2 = ((word >> 5) ^ (word >> 4) ^ (word >> 1) ^ word) & 1; // p2 ^ d1 ^ d3 ^ d4
+    unsigned char s3 = ((word >> 3) ^ (word >> 2) ^ (word >> 1) ^ word) & 1; // p3 ^ d2 ^ d3 ^ d4
+    return (s3 << 2) | (s2 << 1) | s1;
+  }
+  
+  /**
+   * Método auxiliar que comprueba si una palabra es una palabra código del modo actual
+   * @param word Palabra de 7 bits (modo (7,4)) u 8 bits (modo SECDED, p0 en el bit 0)
+   * @return true si la palabra es una palabra código válida
+   */
+  bool isCodeword(unsigned char word) {
+    if (mode == MODE_SECDED_8_4) {
+      return codewordSyndrome(word >> 1) == 0 && (__builtin_popcount(word) % 2) == 0;
+    }
+    return codewordSyndrome(word) == 0;
+  }
+  
+  /**
+   * Método auxiliar que devuelve los contadores del hilo actual
+   * @return Contadores del hilo, o NULL si DECODER_STATS está a 0
+   */
+  HammingCounters *localCounters() {
+#if DECODER_STATS
+    return &stats.local();
+#else
+    return NULL;
+#endif
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método auxiliar que añade una palabra de 7 bits decodificada al histograma
+   * @param counters Contadores a actualizar
+   * @param word Palabra recibida (p1 en el bit 6)
+   */
+  static void countCodeword(HammingCounters *counters, unsigned char word) {
+    unsigned char syndrome = codewordSyndrome(word);
+    counters->syndromes[syndrome == 0 ? 0 : (syndrome | 8)]++;
+  }
+  
+  /**
+   * Método auxiliar que añade una palabra SECDED decodificada al histograma
+   * @param counters Contadores a actualizar
+   * @param word Palabra recibida de 8 bits (p0 en el bit 0)
+   */
+  static void countSecdedCodeword(HammingCounters *counters, unsigned char word) {
+    unsigned char parityFails = __builtin_popcount(word) & 1;
+    counters->syndromes[codewordSyndrome(word >> 1) | (parityFails << 3)]++;
+  }
+#endif
+  
+  /**
+   * Método auxiliar que traspone matrices de 8 x 8 bits, una por cada palabra de 64 bits.
+   * La fila r es el byte r contando desde el más significativo y la columna c es el bit
+   * 7 - c de cada byte.
+   * @param x Matrices de 8 x 8 bits
+   * @return Matrices traspuestas
+   */
+  static SliceWord transposeBits(SliceWord x) {
+    SliceWord t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+  }
+  
+  /**
+   * Método auxiliar que traspone matrices de 8 x 8 bytes: el byte j de words[g] pasa a
+   * ser el byte g de words[j] (bytes contados desde el más significativo)
+   * @param words Filas de las matrices
+   */
+  static void transposeBytes(SliceWord *words) {
+    // Intercambiar bloques de 32, 16 y 8 bits entre filas a distancia 4, 2 y 1
+    for (int i = 0; i < 4; i++) {
+      swapBlocks(words[i], words[i + 4], 32, 0xFFFFFFFF00000000ULL);
+    }
+    for (int i = 0; i < 2; i++) {
+      swapBlocks(words[i], words[i + 2], 16, 0xFFFF0000FFFF0000ULL);
+      swapBlocks(words[i + 4], words[i + 6], 16, 0xFFFF0000FFFF0000ULL);
+    }
+    for (int i = 0; i < 8; i += 2) {
+      swapBlocks(words[i], words[i + 1], 8, 0xFF00FF00FF00FF00ULL);
+    }
+  }
+  
+  /**
+   * Método auxiliar que intercambia bloques de bits entre dos filas: los bloques bajos de
+   * high pasan a ser los altos de low y viceversa
+   * @param high Fila superior
+   * @param low Fila inferior
+   * @param shift Tamaño de los bloques en bits
+   * @param mask Máscara de los bloques altos
+   */
+  static void swapBlocks(SliceWord &high, SliceWord &low, int shift, uint64_t mask) {
+    SliceWord newHigh = (high & mask) | ((low >> shift) & ~mask);
+    SliceWord newLow = ((high << shift) & mask) | (low & ~mask);
+    high = newHigh;
+    low = newLow;
+  }
+  
+  /**
+   * Método auxiliar que separa 8 palabras código de 7 bits seguidas (56 bits menos
+   * significativos) en 8 bytes, con cada palabra alineada a la izquierda de su byte
+   * @param packed Palabras código empaquetadas
+   * @return Palabra i en el byte i contando desde el más significativo
+   */
+  static SliceWord spreadCodewords(SliceWord packed) {
+    // La palabra k (contando desde la menos significativa) se desplaza k bits en tres pasos
+    packed = ((packed & 0x00FFFFFFF0000000ULL) << 4) | (packed & 0x000000000FFFFFFFULL);
+    packed = ((packed & 0x0FFFC0000FFFC000ULL) << 2) | (packed & ~0x0FFFC0000FFFC000ULL);
+    packed = ((packed & 0x3F803F803F803F80ULL) << 1) | (packed & ~0x3F803F803F803F80ULL);
+    return packed << 1;
+  }
+  
+  /**
+   * Método auxiliar que decodifica SLICE_CODEWORDS palabras código con bit slicing. Las
+   * palabras se trasponen a 7 planos de bits (planes[j] contiene el bit j de todas ellas),
+   * el síndrome y la corrección se calculan a la vez para todas con operaciones lógicas,
+   * y los 4 planos de datos se vuelven a trasponer. Cada palabra de 64 bits de SliceWord
+   * lleva un bloque independiente de 64 palabras código (56 bytes de entrada).
+   * @param in Vector de entrada (SLICE_LANES bloques de 56 bytes)
+   * @param out Vector de salida (SLICE_LANES bloques de 32 bytes)
+   * @param counters Contadores del histograma (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decodeSlicedBlock(unsigned char *in, unsigned char *out, HammingCounters *counters) {
+    // Leer cada bloque como 7 palabras de 64 bits (la octava queda a 0)
+    SliceWord stream[8];
+    memset(stream, 0, sizeof(stream));
+    for (int k = 0; k < 7; k++) {
+      uint64_t lanes[SLICE_LANES];
+      for (int lane = 0; lane < SLICE_LANES; lane++) {
+        memcpy(&lanes[lane], in + 56 * lane + 8 * k, 8);
+        lanes[lane] = __builtin_bswap64(lanes[lane]); // Primer byte en la parte alta
+      }
+      memcpy(&stream[k], lanes, sizeof(SliceWord));
+    }
+    
+    // Cada grupo de 8 palabras código (56 bits) se separa en bytes y se traspone: el byte j
+    // de planes[g] pasa a contener el bit j de las 8 palabras del grupo
+    SliceWord planes[8];
+    for (int g = 0; g < 8; g++) {
+      int word = (56 * g) / 64;
+      int shift = (56 * g) % 64;
+      SliceWord packed = stream[word] << shift;
+      if (shift > 8) {
+        packed |= stream[word + 1] >> (64 - shift);
+      }
+      planes[g] = transposeBits(spreadCodewords(packed >> 8));
+    }
+    
+    // Reunir los bytes de los 8 grupos: planes[j] contiene el bit j de las 64 palabras
+    transposeBytes(planes);
+    
+    // Síndrome y corrección de las 64 palabras a la vez
+    SliceWord s1 = planes[0] ^ planes[2] ^ planes[4] ^ planes[6]; // p1 ^ d1 ^ d2 ^ d4
+    SliceWord s2 = planes[1] ^ planes[2] ^ planes[5] ^ planes[6]; // p2 ^ d1 ^ d3 ^ d4
+    SliceWord s3 = planes[3] ^ planes[4] ^ planes[5] ^ planes[6]; // p3 ^ d2 ^ d3 ^ d4
+#if DECODER_STATS
+    if (counters != NULL) {
+      // Palabras con cada síndrome no nulo; el resto tiene síndrome 0
+      uint32_t withErrors = 0;
+      for (int syndrome = 1; syndrome < 8; syndrome++) {
+        SliceWord match = ((syndrome & 1) ? s1 : ~s1) & ((syndrome & 2) ? s2 : ~s2) & ((syndrome & 4) ? s3 : ~s3);
+        uint64_t lanes[SLICE_LANES];
+        memcpy(lanes, &match, sizeof(SliceWord));
+        uint32_t count = 0;
+        for (int lane = 0; lane < SLICE_LANES; lane++) {
+          count += __builtin_popcountll(lanes[lane]);
+        }
+        counters->syndromes[syndrome | 8] += count;
+        withErrors += count;
+      }
+      counters->syndromes[0] += SLICE_CODEWORDS - withErrors;
+    }
+#else
+    (void)counters;
+#endif
+    SliceWord data[8];
+    memset(data, 0, sizeof(data));
+    data[0] = planes[2] ^ (s1 & s2 & ~s3);  // d1 (posición 3)
+    data[1] = planes[4] ^ (s1 & ~s2 & s3);  // d2 (posición 5)
+    data[2] = planes[5] ^ (~s1 & s2 & s3);  // d3 (posición 6)
+    data[3] = planes[6] ^ (s1 & s2 & s3);   // d4 (posición 7)
+    
+    // Deshacer la trasposición: cada palabra deja su nibble en los 4 bits altos de su byte
+    transposeBytes(data);
+    for (int g = 0; g < 8; g++) {
+      SliceWord nibbles = (transposeBits(data[g]) & 0xF0F0F0F0F0F0F0F0ULL) >> 4;
+      
+      // Juntar los nibbles de dos en dos: 4 bytes de salida en los 32 bits bajos
+      nibbles = (nibbles | (nibbles >> 4)) & 0x00FF00FF00FF00FFULL;
+      nibbles = (nibbles | (nibbles >> 8)) & 0x0000FFFF0000FFFFULL;
+      nibbles = (nibbles | (nibbles >> 16)) & 0x00000000FFFFFFFFULL;
+      
+      uint64_t lanes[SLICE_LANES];
+      memcpy(lanes, &nibbles, sizeof(SliceWord));
+      for (int lane = 0; lane < SLICE_LANES; lane++) {
+        uint32_t bytes = __builtin_bswap32((uint32_t)lanes[lane]); // Primer byte en la parte alta
+        memcpy(out + 32 * lane + 4 * g, &bytes, 4);
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que decodifica con DECODE_TABLE a partir de una palabra código dada.
+   * Cada palabra de 7 bits se corrige y se convierte en su nibble con una consulta a la
+   * tabla. Las palabras se leen de una palabra de 64 bits: 7 bytes de entrada contienen
+   * exactamente 8 palabras código, que dan 4 bytes de salida.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param firstCodeword Primera palabra código que se decodifica (múltiplo de 8)
+   */
+  void decodeWithTable(unsigned char *in, unsigned char *out, int length, int firstCodeword) {
+    int codewords = (length * 8) / 7; // Número de palabras código completas
+    int blocks = codewords / 8;       // Bloques de 7 bytes de entrada (8 palabras código)
+#if DECODER_STATS
+    HammingCounters *counters = localCounters();
+#endif
+    
+    for (int block = firstCodeword / 8; block < blocks; block++) {
+      uint64_t buffer = 0;
+      for (int k = 0; k < 7; k++) {
+        buffer = (buffer << 8) | in[block * 7 + k];
+      }
+      for (int i = 0; i < 4; i++) {
+        unsigned char high = DECODE_TABLE[(buffer >> (49 - 14 * i)) & 0x7F];
+        unsigned char low = DECODE_TABLE[(buffer >> (42 - 14 * i)) & 0x7F];
+        out[block * 4 + i] = (high << 4) | low;
+      }
+#if DECODER_STATS
+      if (counters != NULL) {
+        for (int k = 0; k < 8; k++) {
+          countCodeword(counters, (buffer >> (49 - 7 * k)) & 0x7F);
+        }
+      }
+#endif
+    }
+    
+    // Palabras código restantes: se leen de 7 en 7 bits cargando bytes según se necesitan
+    uint64_t buffer = 0;           // Bits pendientes de leer, alineados a la derecha
+    int bufferBits = 0;            // Número de bits pendientes
+    int inByteIndex = blocks * 7;  // Siguiente byte de entrada
+    int outByteIndex = blocks * 4; // Byte de salida actual
+    for (int c = blocks * 8; c < codewords; c++) {
+      if (bufferBits < 7) {
+        buffer = (buffer << 8) | in[inByteIndex++];
+        bufferBits += 8;
+      }
+      bufferBits -= 7;
+      unsigned char nibble = DECODE_TABLE[(buffer >> bufferBits) & 0x7F];
+#if DECODER_STATS
+      if (counters != NULL) {
+        countCodeword(counters, (buffer >> bufferBits) & 0x7F);
+      }
+#endif
+      
+      // Las palabras pares van a la parte alta del byte y las impares a la parte baja
+      if (c % 2 == 0) {
+        out[outByteIndex] = nibble << 4;
+      } else {
+        out[outByteIndex++] |= nibble;
+      }
+    }
+  }
+  
 public:
   /**
    * Constructor de la clase
+   * @param codeMode Variante del código (por defecto, Hamming (7,4))
+   */
+  HammingCode(Mode codeMode = MODE_7_4) {
+    mode = codeMode;
+  }
+  
+  /**
+   * Método para establecer la variante del código
+   * @param codeMode Nueva variante
+   */
+  void setMode(Mode codeMode) {
+    mode = codeMode;
+  }
+  
+  /**
+   * Método para obtener la variante del código
+   * @return Variante actual
+   */
+  Mode getMode() {
+    return mode;
+  }
+  
+  /**
+   * Método para obtener la palabra código (7,4) de un nibble
+   * @param nibble Valor de 4 bits
+   * @return Palabra código de 7 bits (p1 en el bit 6, d4 en el bit 0)
+   */
+  static unsigned char encodeNibble(unsigned char nibble) {
+    return ENCODE_TABLE[nibble & 0x0F];
+  }
+  
+  /**
+   * Método para corregir una palabra código (7,4) y obtener su nibble
+   * @param word Palabra recibida de 7 bits (p1 en el bit 6, d4 en el bit 0)
+   * @return Nibble decodificado
    */
-  HammingCode() {
-    // No se requieren parámetros para Hamming (7,4)
+  static unsigned char decodeCodeword(unsigned char word) {
+    return DECODE_TABLE[word & 0x7F];
   }
   
   /**
@@ -40,451 +581,2608 @@ public:
    * @return Longitud del mensaje codificado en bytes
    */
   int getEncodedLength(int originalLength) {
+    if (mode == MODE_SECDED_8_4) {
+      return originalLength * 2; // Un byte por cada bloque de 4 bits
+    }
+    
     // Cada byte tiene 2 bloques de 4 bits, y cada bloque genera 7 bits
     int codedBits = originalLength * 2 * 7; // Número total de bits en la salida codificada
     return (codedBits + 7) / 8; // Redondeo hacia arriba para obtener bytes
   }
   
   /**
-   * Método para codificar un mensaje utilizando Hamming (7,4)
+   * Método para codificar un mensaje utilizando Hamming (7,4).
+   * Cada nibble se codifica con una consulta a ENCODE_TABLE y las palabras de 7 bits se
+   * acumulan en una palabra de 64 bits: 4 bytes de entrada dan exactamente 56 bits, que se
+   * escriben como 7 bytes de salida.
    * @param in Vector binario de entrada empaquetado en unsigned char
    * @param out Vector binario de salida empaquetado en unsigned char
    * @param length Longitud del vector de entrada en bytes
    */
   void encode(unsigned char *in, unsigned char *out, int length) {
-    int outBitIndex = 0; // Índice del bit actual en el vector de salida
+    if (mode == MODE_SECDED_8_4) {
+      // Cada nibble da un byte de salida
+      for (int i = 0; i < length; i++) {
+        out[2 * i] = SECDED_ENCODE_TABLE[in[i] >> 4];
+        out[2 * i + 1] = SECDED_ENCODE_TABLE[in[i] & 0x0F];
+      }
+      return;
+    }
     
-    // Recorrer cada byte del vector de entrada
-    for (int i = 0; i < length; i++) {
-      // Procesar cada bloque de 4 bits del byte actual (primero los 4 bits más significativos)
-      for (int nibbleIndex = 0; nibbleIndex < 2; nibbleIndex++) {
-        // Extraer el bloque de 4 bits
-        unsigned char nibble;
-        if (nibbleIndex == 0) {
-          // Extraer los 4 bits más significativos (posiciones 7-4)
-          nibble = (in[i] >> 4) & 0x0F;
-        } else {
-          // Extraer los 4 bits menos significativos (posiciones 3-0)
-          nibble = in[i] & 0x0F;
-        }
-        
-        // Extraer los bits de datos individuales (d1, d2, d3, d4)
-        unsigned char d1 = (nibble >> 3) & 1; // Bit más significativo
-        unsigned char d2 = (nibble >> 2) & 1;
-        unsigned char d3 = (nibble >> 1) & 1;
-        unsigned char d4 = nibble & 1;        // Bit menos significativo
-        
-        // Calcular los bits de paridad según las ecuaciones de Hamming (7,4)
-        unsigned char p1 = d1 ^ d2 ^ d4;      // p1 = d1 + d2 + d4 (XOR)
-        unsigned char p2 = d1 ^ d3 ^ d4;      // p2 = d1 + d3 + d4 (XOR)
-        unsigned char p3 = d2 ^ d3 ^ d4;      // p3 = d2 + d3 + d4 (XOR)
-        
-        // Formar la palabra código de 7 bits: p1, p2, d1, p3, d2, d3, d4
-        unsigned char resultado[7] = {p1, p2, d1, p3, d2, d3, d4};
-        
-        // Colocar los 7 bits de la palabra código en el vector de salida
-        for (int j = 0; j < 7; j++) {
-          // Calcular el índice del byte de salida donde se colocará el bit
-          int outByteIndex = outBitIndex / 8;
-          // Calcular la posición del bit dentro del byte de salida
-          int outBitPosition = 7 - (outBitIndex % 8);
-          
-          // Si estamos en un nuevo byte, inicializarlo a 0
-          if (outBitPosition == 7) {
-            out[outByteIndex] = 0;
-          }
-          
-          // Colocar el bit en la posición correspondiente del byte de salida
-          out[outByteIndex] |= (resultado[j] << outBitPosition);
-          
-          // Incrementar el índice del bit de salida
-          outBitIndex++;
-        }
+    int blocks = length / 4; // Bloques de 4 bytes de entrada (8 palabras código)
+    
+    for (int block = 0; block < blocks; block++) {
+      uint64_t buffer = 0;
+      for (int i = 0; i < 4; i++) {
+        unsigned char value = in[block * 4 + i];
+        buffer = (buffer << 14) | (ENCODE_TABLE[value >> 4] << 7) | ENCODE_TABLE[value & 0x0F];
+      }
+      for (int k = 0; k < 7; k++) {
+        out[block * 7 + k] = (unsigned char)(buffer >> (48 - 8 * k));
+      }
+    }
+    
+    // Bytes restantes: se escriben los bytes completos según se van llenando
+    uint64_t buffer = 0;             // Bits pendientes de escribir, alineados a la derecha
+    int bufferBits = 0;              // Número de bits pendientes
+    int outByteIndex = blocks * 7;   // Siguiente byte de salida
+    for (int i = blocks * 4; i < length; i++) {
+      buffer = (buffer << 14) | (ENCODE_TABLE[in[i] >> 4] << 7) | ENCODE_TABLE[in[i] & 0x0F];
+      bufferBits += 14;
+      while (bufferBits >= 8) {
+        bufferBits -= 8;
+        out[outByteIndex++] = (unsigned char)(buffer >> bufferBits);
       }
     }
+    
+    // Último byte incompleto, completado con ceros
+    if (bufferBits > 0) {
+      out[outByteIndex] = (unsigned char)(buffer << (8 - bufferBits));
+    }
   }
   
   /**
-   * Método para decodificar un mensaje codificado con Hamming (7,4)
+   * Método para decodificar un mensaje codificado con Hamming (7,4). Si hay AVX2 se usa el
+   * decodificador por bit slicing, que es el más rápido; si no, el de tabla.
    * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
    * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
    * @param length Longitud del vector de entrada en bytes
    */
   void decode(unsigned char *in, unsigned char *out, int length) {
+    if (mode == MODE_SECDED_8_4) {
+      decodeWithFlags(in, out, NULL, length);
+      return;
+    }
+    
+#if defined(__AVX2__)
+    decodeBitSliced(in, out, length);
+#else
+    decodeWithTable(in, out, length, 0);
+#endif
+  }
+  
+  /**
+   * Método para decodificar un mensaje Hamming (7,4) por bit slicing: las palabras código
+   * se procesan de SLICE_CODEWORDS en SLICE_CODEWORDS (64, o 256 con AVX2) y las que
+   * sobran al final se decodifican con la tabla. El resultado es idéntico al de decode.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decodeBitSliced(unsigned char *in, unsigned char *out, int length) {
+    int blocks = ((length * 8) / 7) / SLICE_CODEWORDS;
+    HammingCounters *counters = localCounters();
+    
+    for (int block = 0; block < blocks; block++) {
+      decodeSlicedBlock(in + block * SLICE_CODEWORDS * 7 / 8, out + block * SLICE_CODEWORDS / 2, counters);
+    }
+    decodeWithTable(in, out, length, blocks * SLICE_CODEWORDS);
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método para obtener el histograma de síndromes de todas las palabras decodificadas
+   * con decode, decodeBitSliced y decodeWithFlags desde la última llamada a resetStats
+   * (sumando los de todos los hilos)
+   * @return Contadores acumulados
+   */
+  HammingCounters getStats() {
+    return stats.read();
+  }
+  
+  /**
+   * Método para poner a 0 los contadores
+   */
+  void resetStats() {
+    stats.reset();
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal a partir de los síndromes
+   * @return Estimación de f
+   */
+  float estimateChannelErrorRate() {
+    return stats.read().estimateErrorRate(mode == MODE_SECDED_8_4 ? 8 : 7);
+  }
+#endif
+  
+  /**
+   * Método para decodificar un mensaje indicando qué palabras código no se han podido
+   * corregir. En modo SECDED cada byte de entrada es una palabra código, así que basta
+   * una consulta a SECDED_DECODE_TABLE por byte; las palabras con dos errores se marcan
+   * en lugar de corregirse mal. En modo (7,4) no se pueden detectar y todas las marcas
+   * quedan a 0.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param uncorrectable Marca de cada palabra código (1 = no corregible); puede ser NULL
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de palabras código no corregibles
+   */
+  int decodeWithFlags(unsigned char *in, unsigned char *out, unsigned char *uncorrectable, int length) {
+    if (mode != MODE_SECDED_8_4) {
+      decode(in, out, length);
+      if (uncorrectable != NULL) {
+        for (int c = 0; c < (length * 8) / 7; c++) {
+          uncorrectable[c] = 0;
+        }
+      }
+      return 0;
+    }
+    
+    int failures = 0; // Palabras código no corregibles
+#if DECODER_STATS
+    HammingCounters *counters = localCounters();
+#endif
+    
+    for (int c = 0; c < length; c++) {
+      unsigned char decoded = SECDED_DECODE_TABLE[in[c]];
+#if DECODER_STATS
+      if (counters != NULL) {
+        countSecdedCodeword(counters, in[c]);
+      }
+#endif
+      unsigned char flag = (decoded & UNCORRECTABLE) ? 1 : 0;
+      failures += flag;
+      if (uncorrectable != NULL) {
+        uncorrectable[c] = flag;
+      }
+      
+      // Las palabras pares van a la parte alta del byte y las impares a la parte baja
+      if (c % 2 == 0) {
+        out[c / 2] = (decoded & 0x0F) << 4;
+      } else {
+        out[c / 2] |= decoded & 0x0F;
+      }
+    }
+    return failures;
+  }
+  
+  /**
+   * Método para decodificar un mensaje recibido por un canal de borrado.
+   * Para cada palabra código se prueban todos los valores posibles de los bits borrados y
+   * se elige el que da una palabra válida. Como la distancia mínima es 3 en (7,4) y 4 en
+   * SECDED, la solución es única con hasta dos o tres bits borrados respectivamente; con
+   * más borrados solo se recupera la palabra si sigue habiendo una única solución. Las
+   * palabras sin borrados se decodifican como en decode.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de palabras código que no se han podido recuperar sin ambigüedad
+   */
+  int decodeErasures(unsigned char *in, unsigned char *erasures, unsigned char *out, int length) {
+    int wordBits = (mode == MODE_SECDED_8_4) ? 8 : 7; // Bits de cada palabra código
     int inBitIndex = 0;   // Índice del bit actual en el vector de entrada
     int outBitIndex = 0;  // Índice del bit actual en el vector de salida
+    int failures = 0;     // Palabras código no recuperadas
     
-    // Inicializar el vector de salida a ceros
-    int outBytes = (length * 8 * 4) / 7; // Aproximación del número de bytes necesarios
-    outBytes = (outBytes + 7) / 8;  // Redondeo hacia arriba
+    // Número exacto de palabras código completas y de bytes de salida
+    int codewords = (length * 8) / wordBits;
+    int outBytes = (codewords * 4 + 7) / 8;
     
     for (int i = 0; i < outBytes; i++) {
       out[i] = 0;
     }
     
-    // Procesar cada palabra código de 7 bits
-    while (inBitIndex + 6 < length * 8) { // Asegurarse de que hay al menos 7 bits disponibles
-      // Extraer los 7 bits de la palabra código
-      unsigned char codeword[7];
-      
-      for (int j = 0; j < 7; j++) {
-        // Calcular el índice del byte de entrada y la posición del bit
+    for (int c = 0; c < codewords; c++) {
+      // Leer la palabra código y su máscara de borrados (p1 en el bit más significativo)
+      unsigned char word = 0;
+      unsigned char erased = 0;
+      for (int j = 0; j < wordBits; j++) {
         int inByteIndex = inBitIndex / 8;
         int inBitPosition = 7 - (inBitIndex % 8);
-        
-        // Extraer el bit de la posición correspondiente
-        codeword[j] = (in[inByteIndex] >> inBitPosition) & 1;
-        
-        // Avanzar al siguiente bit de entrada
+        word = (word << 1) | ((in[inByteIndex] >> inBitPosition) & 1);
+        erased = (erased << 1) | ((erasures[inByteIndex] >> inBitPosition) & 1);
         inBitIndex++;
       }
       
-      // Extraer bits de paridad y datos de la palabra código
-      unsigned char p1 = codeword[0]; // Bit de paridad 1
-      unsigned char p2 = codeword[1]; // Bit de paridad 2
-      unsigned char d1 = codeword[2]; // Bit de dato 1
-      unsigned char p3 = codeword[3]; // Bit de paridad 3
-      unsigned char d2 = codeword[4]; // Bit de dato 2
-      unsigned char d3 = codeword[5]; // Bit de dato 3
-      unsigned char d4 = codeword[6]; // Bit de dato 4
+      unsigned char nibble;
+      if (erased == 0) {
+        // Sin borrados: decodificar con las tablas
+        if (mode == MODE_SECDED_8_4) {
+          nibble = SECDED_DECODE_TABLE[word];
+          if (nibble & UNCORRECTABLE) {
+            failures++;
+          }
+          nibble &= 0x0F;
+        } else {
+          nibble = DECODE_TABLE[word];
+        }
+      } else {
+        // Probar todas las combinaciones de los bits borrados
+        int solutions = 0;
+        unsigned char solution = word & ~erased;
+        unsigned char fill = erased;
+        while (true) {
+          unsigned char candidate = (word & ~erased) | fill;
+          if (isCodeword(candidate)) {
+            solutions++;
+            solution = candidate;
+          }
+          if (fill == 0) {
+            break;
+          }
+          fill = (fill - 1) & erased;
+        }
+        if (solutions != 1) {
+          failures++;
+        }
+        
+        // Quitar la paridad global y extraer los bits de datos d1, d2, d3, d4
+        if (mode == MODE_SECDED_8_4) {
+          solution >>= 1;
+        }
+        nibble = (((solution >> 4) & 1) << 3) | (((solution >> 2) & 1) << 2) | (solution & 0x03);
+      }
+      
+      if (outBitIndex % 8 == 0) {
+        out[outBitIndex / 8] |= (nibble << 4);
+      } else {
+        out[outBitIndex / 8] |= nibble;
+      }
+      outBitIndex += 4;
+    }
+    return failures;
+  }
+  
+};
+
+/**
+ * Contadores del decodificador de repetición (ver DECODER_STATS). Una votación es unánime
+ * si todas las copias del bit coinciden; si está dividida, el canal ha cambiado al menos
+ * una copia, aunque la mayoría lo corrija.
+ */
+struct RepetitionCounters {
+  uint32_t unanimousVotes; // Votaciones con todas las copias iguales
+  uint32_t splitVotes;     // Votaciones con alguna copia distinta
+  
+  /**
+   * Método para añadir una votación
+   * @param unanimous true si todas las copias coinciden
+   */
+  void addVote(bool unanimous) {
+    if (unanimous) {
+      unanimousVotes++;
+    } else {
+      splitVotes++;
+    }
+  }
+  
+  /**
+   * Método para añadir hasta 64 votaciones calculadas en paralelo
+   * @param allOnes AND de las copias (1 donde todas valen 1)
+   * @param anyOnes OR de las copias (1 donde alguna vale 1)
+   * @param valid Máscara de las posiciones que son votaciones reales
+   */
+  void addVotes(uint64_t allOnes, uint64_t anyOnes, uint64_t valid) {
+    int unanimous = __builtin_popcountll((allOnes | ~anyOnes) & valid);
+    unanimousVotes += unanimous;
+    splitVotes += __builtin_popcountll(valid) - unanimous;
+  }
+  
+  /**
+   * Método para acumular los contadores de otro hilo
+   * @param other Contadores a sumar
+   */
+  void merge(const RepetitionCounters &other) {
+    unanimousVotes += other.unanimousVotes;
+    splitVotes += other.splitVotes;
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal. Una votación es unánime si no
+   * falla ninguna de las n copias, con probabilidad (1 - f)^n (se desprecia el caso de que
+   * fallen todas), así que f = 1 - (unánimes / total)^(1/n).
+   * @param copies Grado de repetición n
+   * @return Estimación de f (0 si no hay votaciones)
+   */
+  float estimateErrorRate(int copies) const {
+    uint32_t votes = unanimousVotes + splitVotes;
+    if (votes == 0) {
+      return 0;
+    }
+    return 1 - powf((float)unanimousVotes / votes, 1.0f / copies);
+  }
+};
+
+/**
+ * Clase que implementa la codificación y decodificación por repetición válida para
+ * cualquier grado. Es la implementación de referencia y la que usa RepetitionCode
+ * cuando no existe una versión especializada para el grado elegido.
+ */
+class GenericRepetitionCode {
+private:
+  int repetitionDegree; // Grado de repetición (número de veces que se repite cada bit)
+  
+  // Valor absoluto máximo de la fiabilidad (cabe en un int8_t)
+  static const int RELIABILITY_MAX = 127;
+  
+  /**
+   * Método auxiliar que limita una fiabilidad al rango de un int8_t
+   * @param margin Margen de la votación
+   * @return Margen limitado a [-RELIABILITY_MAX, RELIABILITY_MAX]
+   */
+  static int clampReliability(int margin) {
+    if (margin > RELIABILITY_MAX) {
+      return RELIABILITY_MAX;
+    }
+    if (margin < -RELIABILITY_MAX) {
+      return -RELIABILITY_MAX;
+    }
+    return margin;
+  }
+  
+  // Tabla que reparte los 8 bits de un byte en 8 carriles de un byte: el carril k (el byte k
+  // en memoria) vale 1 si el bit 7 - k del byte vale 1. Se genera en tiempo de compilación
+  struct SpreadTable {
+    uint64_t lanes[256];
+    
+    constexpr SpreadTable() : lanes() {
+      for (int v = 0; v < 256; v++) {
+        for (int k = 0; k < 8; k++) {
+          int shift = (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) ? 8 * k : 8 * (7 - k);
+          lanes[v] |= (uint64_t)((v >> (7 - k)) & 1) << shift;
+        }
+      }
+    }
+  };
+  
+  // Se define después de la clase, cuando SpreadTable ya está completa
+  static const SpreadTable SPREAD_TABLE;
+  
+public:
+  /**
+   * Constructor de la clase
+   * @param n Grado de repetición (número de veces que se repite cada bit)
+   */
+  GenericRepetitionCode(int n) {
+    repetitionDegree = n;
+  }
+  
+  /**
+   * Método para establecer el grado de repetición
+   * @param n Nuevo grado de repetición
+   */
+  void setRepetitionDegree(int n) {
+    repetitionDegree = n;
+  }
+  
+  /**
+   * Método para obtener el grado de repetición actual
+   * @return Grado de repetición
+   */
+  int getRepetitionDegree() {
+    return repetitionDegree;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje codificado en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud del mensaje codificado en bytes
+   */
+  int getEncodedLength(int originalLength) {
+    return (originalLength * 8 * repetitionDegree + 7) / 8; // Redondeo hacia arriba
+  }
+  
+  /**
+   * Método para codificar un mensaje utilizando repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void encode(unsigned char *in, unsigned char *out, int length) {
+    encodeBits(in, out, length, repetitionDegree);
+  }
+  
+  /**
+   * Método para decodificar un mensaje codificado con repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decode(unsigned char *in, unsigned char *out, int length) {
+    decodeBits(in, out, length, repetitionDegree);
+  }
+  
+  /**
+   * Método para decodificar un mensaje recibido por un canal de borrado.
+   * La votación solo tiene en cuenta las copias que no se han borrado; si se han borrado
+   * todas las copias de un bit, no se puede recuperar y se decodifica como 0.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de bits que no se han podido recuperar
+   */
+  int decodeErasures(unsigned char *in, unsigned char *erasures, unsigned char *out, int length) {
+    int inBitIndex = 0;  // Índice del bit actual en el vector de entrada
+    int outBitIndex = 0; // Índice del bit actual en el vector de salida
+    int lostBits = 0;    // Bits con todas sus copias borradas
+    
+    // Inicializar el vector de salida a ceros
+    int outLength = (length * 8) / repetitionDegree; // Número total de bits en el mensaje original
+    int outBytes = (outLength + 7) / 8; // Número de bytes necesarios para almacenar el mensaje original
+    
+    for (int i = 0; i < outBytes; i++) {
+      out[i] = 0;
+    }
+    
+    // Procesar cada grupo de n bits repetidos
+    while (inBitIndex + repetitionDegree <= length * 8) {
+      int countOnes = 0;  // Copias no borradas que valen 1
+      int countZeros = 0; // Copias no borradas que valen 0
       
-      // Calcular el síndrome para detectar errores
-      unsigned char s1 = p1 ^ d1 ^ d2 ^ d4; // Verificar paridad 1
-      unsigned char s2 = p2 ^ d1 ^ d3 ^ d4; // Verificar paridad 2
-      unsigned char s3 = p3 ^ d2 ^ d3 ^ d4; // Verificar paridad 3
+      for (int k = 0; k < repetitionDegree; k++) {
+        int inByteIndex = inBitIndex / 8;
+        int inBitPosition = 7 - (inBitIndex % 8);
+        
+        // Solo votan las copias que no se han borrado
+        if (((erasures[inByteIndex] >> inBitPosition) & 1) == 0) {
+          if ((in[inByteIndex] >> inBitPosition) & 1) {
+            countOnes++;
+          } else {
+            countZeros++;
+          }
+        }
+        inBitIndex++;
+      }
       
-      // Determinar la posición del error (si existe)
-      unsigned char errorPos = (s3 << 2) | (s2 << 1) | s1;
+      if (countOnes + countZeros == 0) {
+        lostBits++;
+      }
       
-      // Corregir el error si se detecta (errorPos != 0)
-      if (errorPos != 0) {
-        // Posiciones de error y su correspondencia en el array codeword
-        // 1 -> p1 (índice 0)
-        // 2 -> p2 (índice 1)
-        // 3 -> d1 (índice 2)
-        // 4 -> p3 (índice 3)
-        // 5 -> d2 (índice 4)
-        // 6 -> d3 (índice 5)
-        // 7 -> d4 (índice 6)
+      // Votación por mayoría entre las copias recibidas
+      unsigned char decodedBit = (countOnes > countZeros) ? 1 : 0;
+      out[outBitIndex / 8] |= (decodedBit << (7 - (outBitIndex % 8)));
+      outBitIndex++;
+    }
+    return lostBits;
+  }
+  
+  /**
+   * Método que codifica bit a bit con cualquier grado de repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void encodeBits(unsigned char *in, unsigned char *out, int length, int n) {
+    int outBitIndex = 0; // Índice del bit actual en el vector de salida
+    
+    // Recorrer cada byte del vector de entrada
+    for (int i = 0; i < length; i++) {
+      // Procesar cada bit del byte actual
+      for (int j = 7; j >= 0; j--) {
+        // Extraer el bit j-ésimo del byte i-ésimo
+        unsigned char bit = (in[i] >> j) & 1;
         
-        // Corregir el bit erróneo
-        if (errorPos >= 1 && errorPos <= 7) {
-          // Invertir el bit en la posición del error
-          codeword[errorPos - 1] = codeword[errorPos - 1] ^ 1;
+        // Repetir el bit n veces
+        for (int k = 0; k < n; k++) {
+          // Calcular el índice del byte de salida donde se colocará el bit repetido
+          int outByteIndex = outBitIndex / 8;
+          // Calcular la posición del bit dentro del byte de salida
+          int outBitPosition = 7 - (outBitIndex % 8);
+          
+          // Si estamos en un nuevo byte, inicializarlo a 0
+          if (outBitPosition == 7) {
+            out[outByteIndex] = 0;
+          }
+          
+          // Colocar el bit en la posición correspondiente del byte de salida
+          out[outByteIndex] |= (bit << outBitPosition);
           
-          // Actualizar los bits de datos si fueron corregidos
-          if (errorPos == 3) d1 = codeword[2];
-          else if (errorPos == 5) d2 = codeword[4];
-          else if (errorPos == 6) d3 = codeword[5];
-          else if (errorPos == 7) d4 = codeword[6];
+          // Incrementar el índice del bit de salida
+          outBitIndex++;
+        }
+      }
+    }
+  }
+  
+  /**
+   * Método que decodifica bit a bit con cualquier grado de repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decodeBits(unsigned char *in, unsigned char *out, int length, int n, RepetitionCounters *counters = NULL) {
+    int inBitIndex = 0;  // Índice del bit actual en el vector de entrada
+    int outBitIndex = 0; // Índice del bit actual en el vector de salida
+    
+    // Inicializar el vector de salida a ceros
+    int outLength = (length * 8) / n; // Número total de bits en el mensaje original
+    int outBytes = (outLength + 7) / 8; // Número de bytes necesarios para almacenar el mensaje original
+    
+    for (int i = 0; i < outBytes; i++) {
+      out[i] = 0;
+    }
+    
+    // Procesar cada grupo de n bits repetidos
+    while (inBitIndex < length * 8) {
+      int countOnes = 0; // Contador de unos en el grupo actual
+      int copies = 0;    // Copias leídas (el último grupo puede estar incompleto)
+      
+      // Contar cuántos unos hay en el grupo de n bits
+      for (int k = 0; k < n && inBitIndex < length * 8; k++) {
+        // Calcular el índice del byte de entrada y la posición del bit
+        int inByteIndex = inBitIndex / 8;
+        int inBitPosition = 7 - (inBitIndex % 8);
+        
+        // Extraer el bit de la posición correspondiente
+        unsigned char bit = (in[inByteIndex] >> inBitPosition) & 1;
+        
+        // Incrementar el contador si el bit es 1
+        if (bit == 1) {
+          countOnes++;
         }
+        
+        // Avanzar al siguiente bit de entrada
+        inBitIndex++;
+        copies++;
       }
       
-      // Reconstruir el nibble (4 bits) original
-      unsigned char nibble = (d1 << 3) | (d2 << 2) | (d3 << 1) | d4;
+#if DECODER_STATS
+      if (counters != NULL) {
+        counters->addVote(countOnes == 0 || countOnes == copies);
+      }
+#else
+      (void)counters;
+#endif
       
-      // Determinar si este nibble va en la parte alta o baja del byte de salida
-      if (outBitIndex % 8 == 0) {
-        // Parte alta del byte (bits 7-4)
-        out[outBitIndex / 8] |= (nibble << 4);
-      } else {
-        // Parte baja del byte (bits 3-0)
-        out[outBitIndex / 8] |= nibble;
+      // Determinar el bit original mediante votación por mayoría
+      unsigned char decodedBit = (countOnes > n / 2) ? 1 : 0;
+      
+      // Calcular el índice del byte de salida y la posición del bit
+      int outByteIndex = outBitIndex / 8;
+      int outBitPosition = 7 - (outBitIndex % 8);
+      
+      // Colocar el bit decodificado en la posición correspondiente del byte de salida
+      out[outByteIndex] |= (decodedBit << outBitPosition);
+      
+      // Avanzar al siguiente bit de salida
+      outBitIndex++;
+    }
+  }
+  
+  /**
+   * Método que codifica con disposición por bloques: el bloque completo se repite n veces
+   * seguidas, de modo que las copias de un mismo bit quedan separadas length bytes
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void encodeBlocks(unsigned char *in, unsigned char *out, int length, int n) {
+    for (int k = 0; k < n; k++) {
+      memcpy(out + k * length, in, length);
+    }
+  }
+  
+  /**
+   * Método que decodifica un mensaje con disposición por bloques. La votación se hace
+   * palabra a palabra (64 bits) con un contador binario en paralelo sobre las n copias,
+   * sin tener que separar ni recolocar bits.
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decodeBlocks(unsigned char *in, unsigned char *out, int length, int n, RepetitionCounters *counters = NULL) {
+    int blockLength = length / n; // Longitud de cada copia del bloque en bytes
+    
+    // Bits necesarios para contar hasta n
+    int countBits = 1;
+    while ((n >> countBits) != 0) {
+      countBits++;
+    }
+    
+    for (int offset = 0; offset < blockLength; offset += 8) {
+      int bytes = (blockLength - offset < 8) ? blockLength - offset : 8;
+      uint64_t count[32] = {0}; // count[b] es el bit b del número de unos de cada posición
+#if DECODER_STATS
+      uint64_t allOnes = ~(uint64_t)0; // Posiciones en las que todas las copias valen 1
+      uint64_t anyOnes = 0;            // Posiciones en las que alguna copia vale 1
+#endif
+      
+      for (int k = 0; k < n; k++) {
+        uint64_t carry = 0;
+        memcpy(&carry, in + k * blockLength + offset, bytes);
+#if DECODER_STATS
+        allOnes &= carry;
+        anyOnes |= carry;
+#endif
+        for (int b = 0; b < countBits && carry != 0; b++) {
+          uint64_t nextCarry = count[b] & carry;
+          count[b] ^= carry;
+          carry = nextCarry;
+        }
       }
       
-      // Avanzar 4 bits en el índice de salida (un nibble)
-      outBitIndex += 4;
+#if DECODER_STATS
+      if (counters != NULL) {
+        uint64_t valid = 0;
+        memset(&valid, 0xFF, bytes);
+        counters->addVotes(allOnes, anyOnes, valid);
+      }
+#else
+      (void)counters;
+#endif
+      
+      uint64_t decoded = atLeast(count, countBits, n / 2 + 1);
+      memcpy(out + offset, &decoded, bytes);
+    }
+  }
+  
+  /**
+   * Método que decodifica con disposición por bloques un mensaje recibido por un canal
+   * de borrado. Solo votan las copias que no se han borrado.
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   * @return Número de bits que no se han podido recuperar
+   */
+  static int decodeErasuresBlocks(unsigned char *in, unsigned char *erasures, unsigned char *out, int length, int n) {
+    int blockLength = length / n; // Longitud de cada copia del bloque en bytes
+    int lostBits = 0;             // Bits con todas sus copias borradas
+    
+    for (int i = 0; i < blockLength; i++) {
+      out[i] = 0;
+      for (int j = 7; j >= 0; j--) {
+        int countOnes = 0;  // Copias no borradas que valen 1
+        int countZeros = 0; // Copias no borradas que valen 0
+        
+        for (int k = 0; k < n; k++) {
+          int byteIndex = k * blockLength + i;
+          if (((erasures[byteIndex] >> j) & 1) == 0) {
+            if ((in[byteIndex] >> j) & 1) {
+              countOnes++;
+            } else {
+              countZeros++;
+            }
+          }
+        }
+        
+        if (countOnes + countZeros == 0) {
+          lostBits++;
+        }
+        if (countOnes > countZeros) {
+          out[i] |= 1 << j;
+        }
+      }
+    }
+    return lostBits;
+  }
+  
+  /**
+   * Método que decodifica bit a bit y además devuelve la fiabilidad de cada bit decodificado,
+   * calculada como el margen de la votación: copias a 0 menos copias a 1. Sigue el mismo
+   * convenio de signo que un LLR (positivo = 0, negativo = 1) y su valor absoluto indica lo
+   * clara que ha sido la mayoría. Las copias de cada bit se cuentan con popcount sobre
+   * palabras de hasta 56 bits en lugar de extraerlas una a una.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param reliability Fiabilidad de cada bit decodificado (un int8_t por bit)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void decodeSoftBits(unsigned char *in, unsigned char *out, int8_t *reliability, int length, int n) {
+    int outLength = (length * 8) / n; // Número de grupos completos de n bits
+    int outBitIndex = 0;              // Índice del bit actual en el vector de salida
+    int inByteIndex = 0;              // Siguiente byte de entrada por leer
+    
+    // Caso habitual (n <= 8): 8 bits decodificados ocupan exactamente n bytes de entrada,
+    // que caben en una palabra de 64 bits, y cada grupo se cuenta con una máscara
+    if (n <= 8) {
+      uint64_t groupMask = ((uint64_t)1 << n) - 1;
+      for (; outBitIndex + 8 <= outLength; outBitIndex += 8) {
+        uint64_t word = 0;
+        for (int k = 0; k < n; k++) {
+          word = (word << 8) | in[inByteIndex++];
+        }
+        
+        unsigned char outByte = 0;
+        for (int g = 0; g < 8; g++) {
+          int countOnes = __builtin_popcountll((word >> (n * (7 - g))) & groupMask);
+          int margin = n - 2 * countOnes;
+          reliability[outBitIndex + g] = (int8_t)clampReliability(margin);
+          outByte = (outByte << 1) | (margin < 0);
+        }
+        out[outBitIndex / 8] = outByte;
+      }
+    }
+    
+    // Resto de grupos (o todos si n > 8): lectura continua a través de un buffer
+    uint64_t buffer = 0;       // Bits pendientes de leer, alineados a la izquierda
+    int bufferBits = 0;        // Número de bits válidos en buffer
+    unsigned char outByte = 0; // Byte de salida en construcción
+    
+    for (; outBitIndex < outLength; outBitIndex++) {
+      int countOnes = 0;
+      int remaining = n;
+      
+      while (remaining > 0) {
+        // Rellenar el buffer byte a byte mientras quepa un byte más
+        while (bufferBits <= 56 && inByteIndex < length) {
+          buffer |= (uint64_t)in[inByteIndex++] << (56 - bufferBits);
+          bufferBits += 8;
+        }
+        
+        int take = (remaining < 56) ? remaining : 56;
+        countOnes += __builtin_popcountll(buffer >> (64 - take));
+        buffer <<= take;
+        bufferBits -= take;
+        remaining -= take;
+      }
+      
+      int margin = n - 2 * countOnes;
+      reliability[outBitIndex] = (int8_t)clampReliability(margin);
+      
+      // El bit decodificado se añade sin saltos condicionales y el byte se escribe entero
+      outByte = (outByte << 1) | (margin < 0);
+      if ((outBitIndex % 8) == 7) {
+        out[outBitIndex / 8] = outByte;
+      }
+    }
+    
+    // Último byte incompleto, alineado a la izquierda
+    if ((outLength % 8) != 0) {
+      out[outLength / 8] = outByte << (8 - outLength % 8);
+    }
+  }
+  
+  /**
+   * Método que decodifica con disposición por bloques y además devuelve la fiabilidad de
+   * cada bit decodificado (copias a 0 menos copias a 1, con el convenio de signo de un LLR).
+   * Los votos se acumulan con el mismo contador binario en paralelo que decodeBlocks.
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param reliability Fiabilidad de cada bit decodificado (un int8_t por bit)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void decodeSoftBlocks(unsigned char *in, unsigned char *out, int8_t *reliability, int length, int n) {
+    int blockLength = length / n; // Longitud de cada copia del bloque en bytes
+    
+    // Bits necesarios para contar hasta n
+    int countBits = 1;
+    while ((n >> countBits) != 0) {
+      countBits++;
+    }
+    
+    for (int offset = 0; offset < blockLength; offset += 8) {
+      int bytes = (blockLength - offset < 8) ? blockLength - offset : 8;
+      uint64_t count[32] = {0}; // count[b] es el bit b del número de unos de cada posición
+      
+      for (int k = 0; k < n; k++) {
+        uint64_t carry = 0;
+        memcpy(&carry, in + k * blockLength + offset, bytes);
+        for (int b = 0; b < countBits && carry != 0; b++) {
+          uint64_t nextCarry = count[b] & carry;
+          count[b] ^= carry;
+          carry = nextCarry;
+        }
+      }
+      
+      uint64_t decoded = atLeast(count, countBits, n / 2 + 1);
+      memcpy(out + offset, &decoded, bytes);
+      
+      // Si n <= RELIABILITY_MAX cada cuenta cabe en un byte: los planos del contador se
+      // reparten en carriles de un byte y los 8 márgenes de cada byte se calculan a la vez.
+      // n + 128 - 2 * cuenta está entre 1 y 255, así que la resta no pasa de un carril a otro,
+      // y el XOR con 0x80 lo convierte en n - 2 * cuenta en complemento a dos
+      if (n <= RELIABILITY_MAX) {
+        const uint64_t LANES = 0x0101010101010101ULL;
+        uint64_t bias = (uint64_t)(n + 128) * LANES;
+        for (int i = 0; i < bytes; i++) {
+          uint64_t counts = 0;
+          for (int b = 0; b < countBits; b++) {
+            counts |= SPREAD_TABLE.lanes[((unsigned char *)&count[b])[i]] << b;
+          }
+          uint64_t margins = (bias - (counts << 1)) ^ (0x80 * LANES);
+          memcpy(reliability + (offset + i) * 8, &margins, 8);
+        }
+      } else {
+        // Grados mayores: la cuenta no cabe en un byte y se lee posición a posición
+        for (int i = 0; i < bytes; i++) {
+          for (int j = 7; j >= 0; j--) {
+            int countOnes = 0;
+            for (int b = 0; b < countBits; b++) {
+              countOnes |= ((((unsigned char *)&count[b])[i] >> j) & 1) << b;
+            }
+            reliability[(offset + i) * 8 + (7 - j)] = (int8_t)clampReliability(n - 2 * countOnes);
+          }
+        }
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que compara un contador binario en paralelo con un umbral
+   * @param count Contador binario (count[b] es el bit b de la cuenta de cada posición)
+   * @param countBits Número de bits del contador
+   * @param threshold Umbral
+   * @return Palabra con un 1 en las posiciones cuya cuenta es mayor o igual que el umbral
+   */
+  static uint64_t atLeast(const uint64_t *count, int countBits, int threshold) {
+    uint64_t greater = 0;
+    uint64_t equal = ~(uint64_t)0;
+    
+    // Comparar del bit más significativo al menos significativo
+    for (int b = countBits - 1; b >= 0; b--) {
+      if ((threshold >> b) & 1) {
+        equal &= count[b];
+      } else {
+        greater |= equal & count[b];
+        equal &= ~count[b];
+      }
+    }
+    return greater | equal;
+  }
+};
+
+constexpr GenericRepetitionCode::SpreadTable GenericRepetitionCode::SPREAD_TABLE = GenericRepetitionCode::SpreadTable();
+
+/**
+ * Clase que implementa un código de repetición con el grado N fijado en tiempo de compilación.
+ * Las tablas se generan en tiempo de compilación (constexpr) y los bucles sobre las N copias
+ * tienen un número de vueltas constante, así que se desenrollan y el umbral de la votación
+ * y la longitud codificada se conocen de antemano.
+ *
+ * - Codificación: cada byte de entrada se convierte exactamente en N bytes de salida, que
+ *   se copian de una tabla de 256 x N bytes.
+ * - Decodificación: cada bloque de 64 bits decodificados se separa en N planos de 64 bits
+ *   (uno por copia) y la votación por mayoría se hace con operaciones lógicas.
+ */
+template <int N>
+class FixedRepetitionCode {
+private:
+  // Palabras de 64 bits necesarias para guardar un byte por cada copia
+  static const int LANE_WORDS = (N + 7) / 8;
+  
+  // Tablas de codificación y de separación en planos, generadas en tiempo de compilación
+  struct Tables {
+    // Los N bytes codificados de cada valor de byte
+    unsigned char encodedBytes[256][N];
+    // Para el byte b de un grupo de N bytes (8 bits decodificados) con valor v, el byte k
+    // de planeLanes[b][v] contiene los bits que ese byte aporta a la copia k
+    uint64_t planeLanes[N][256][LANE_WORDS];
+    
+    constexpr Tables() : encodedBytes(), planeLanes() {
+      for (int v = 0; v < 256; v++) {
+        for (int i = 0; i < 8 * N; i++) {
+          // El bit i de la salida es una copia del bit i / N de la entrada
+          if ((v >> (7 - i / N)) & 1) {
+            encodedBytes[v][i / 8] |= 1 << (7 - i % 8);
+          }
+        }
+      }
+      for (int b = 0; b < N; b++) {
+        for (int v = 0; v < 256; v++) {
+          for (int i = 0; i < 8; i++) {
+            if ((v >> (7 - i)) & 1) {
+              int groupBit = 8 * b + i;      // Posición del bit dentro del grupo
+              int decodedBit = groupBit / N; // Bit decodificado al que pertenece
+              int copy = groupBit % N;       // Copia (plano) a la que pertenece
+              planeLanes[b][v][copy / 8] |= (uint64_t)1 << (8 * (copy % 8) + 7 - decodedBit);
+            }
+          }
+        }
+      }
+    }
+  };
+  
+  static constexpr Tables TABLES = Tables();
+  
+  /**
+   * Método auxiliar que calcula la mayoría de los N planos con operaciones lógicas
+   * @param planes Planos de bits, uno por copia
+   * @return Palabra con un 1 donde más de la mitad de los planos valen 1
+   */
+  static uint64_t majority(const uint64_t *planes) {
+    if (N == 3) {
+      return (planes[0] & planes[1]) | (planes[2] & (planes[0] ^ planes[1]));
+    }
+    
+    // Contador binario en paralelo: count[b] es el bit b del número de unos de cada posición
+    const int COUNT_BITS = (N < 4) ? 2 : (N < 8) ? 3 : 4;
+    uint64_t count[COUNT_BITS] = {0};
+#pragma GCC unroll 16
+    for (int k = 0; k < N; k++) {
+      uint64_t carry = planes[k];
+#pragma GCC unroll 4
+      for (int b = 0; b < COUNT_BITS; b++) {
+        uint64_t nextCarry = count[b] & carry;
+        count[b] ^= carry;
+        carry = nextCarry;
+      }
+    }
+    
+    // Comparar el contador con el umbral N / 2 + 1, del bit más significativo al menos
+    const int THRESHOLD = N / 2 + 1;
+    uint64_t greater = 0;
+    uint64_t equal = ~(uint64_t)0;
+#pragma GCC unroll 4
+    for (int b = COUNT_BITS - 1; b >= 0; b--) {
+      if ((THRESHOLD >> b) & 1) {
+        equal &= count[b];
+      } else {
+        greater |= equal & count[b];
+        equal &= ~count[b];
+      }
+    }
+    return greater | equal;
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método auxiliar que cuenta las votaciones unánimes y divididas de los N planos
+   * @param planes Planos de bits, uno por copia
+   * @param valid Máscara de las posiciones que son votaciones reales
+   * @param counters Contadores a actualizar
+   */
+  static void countVotes(const uint64_t *planes, uint64_t valid, RepetitionCounters *counters) {
+    uint64_t allOnes = planes[0];
+    uint64_t anyOnes = planes[0];
+#pragma GCC unroll 16
+    for (int k = 1; k < N; k++) {
+      allOnes &= planes[k];
+      anyOnes |= planes[k];
+    }
+    counters->addVotes(allOnes, anyOnes, valid);
+  }
+#endif
+  
+public:
+  /**
+   * Método para obtener el grado de repetición
+   * @return Grado de repetición
+   */
+  static constexpr int getRepetitionDegree() {
+    return N;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje codificado en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud del mensaje codificado en bytes
+   */
+  static constexpr int getEncodedLength(int originalLength) {
+    return originalLength * N; // 8 * N bits por byte, siempre un número entero de bytes
+  }
+  
+  /**
+   * Método para codificar un mensaje utilizando repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  static void encode(unsigned char *in, unsigned char *out, int length) {
+    for (int i = 0; i < length; i++) {
+      memcpy(out + i * N, TABLES.encodedBytes[in[i]], N);
+    }
+  }
+  
+  /**
+   * Método para decodificar GROUPS grupos seguidos de N bytes (hasta 8). Cada grupo lleva
+   * 8 bits del mensaje original, así que el resultado cabe en una palabra de 64 bits y se
+   * puede seguir procesando sin escribirlo en memoria.
+   * @param in Vector binario de entrada empaquetado en unsigned char (GROUPS * N bytes)
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   * @return Bits decodificados, con el primer grupo en el byte más significativo
+   */
+  template <int GROUPS>
+  static uint64_t decodeGroups(const unsigned char *in, RepetitionCounters *counters = NULL) {
+    uint64_t planes[N] = {0};
+    
+    // Cada grupo de N bytes aporta 8 bits a cada plano
+#pragma GCC unroll 8
+    for (int g = 0; g < GROUPS; g++) {
+      uint64_t lanes[LANE_WORDS] = {0};
+#pragma GCC unroll 16
+      for (int b = 0; b < N; b++) {
+#pragma GCC unroll 2
+        for (int w = 0; w < LANE_WORDS; w++) {
+          lanes[w] |= TABLES.planeLanes[b][in[g * N + b]][w];
+        }
+      }
+#pragma GCC unroll 16
+      for (int k = 0; k < N; k++) {
+        planes[k] |= ((lanes[k / 8] >> (8 * (k % 8))) & 0xFF) << (56 - 8 * g);
+      }
+    }
+    
+#if DECODER_STATS
+    if (counters != NULL) {
+      countVotes(planes, ~(uint64_t)0 << (64 - 8 * GROUPS), counters);
+    }
+#else
+    (void)counters;
+#endif
+    
+    return majority(planes);
+  }
+  
+  /**
+   * Método para decodificar un mensaje codificado con repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decode(unsigned char *in, unsigned char *out, int length, RepetitionCounters *counters = NULL) {
+    int blocks = length / (8 * N); // Bloques completos de 64 bits decodificados
+    
+    for (int block = 0; block < blocks; block++) {
+      uint64_t decoded = decodeGroups<8>(in + block * 8 * N, counters);
+      for (int g = 0; g < 8; g++) {
+        out[block * 8 + g] = (unsigned char)(decoded >> (56 - 8 * g));
+      }
+    }
+    
+    // Los bytes que no completan un bloque se decodifican bit a bit
+    GenericRepetitionCode::decodeBits(in + blocks * 8 * N, out + blocks * 8, length - blocks * 8 * N, N, counters);
+  }
+  
+  /**
+   * Método para codificar con disposición por bloques (el bloque completo se repite N veces)
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  static void encodeBlocks(unsigned char *in, unsigned char *out, int length) {
+#pragma GCC unroll 16
+    for (int k = 0; k < N; k++) {
+      memcpy(out + k * length, in, length);
+    }
+  }
+  
+  /**
+   * Método para decodificar un mensaje con disposición por bloques. Las N copias de cada
+   * palabra de 64 bits ya son los planos de la votación, así que no hay que separar bits.
+   * @param in Vector binario de entrada empaquetado en unsigned char (N copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decodeBlocks(unsigned char *in, unsigned char *out, int length, RepetitionCounters *counters = NULL) {
+    int blockLength = length / N; // Longitud de cada copia del bloque en bytes
+    
+    for (int offset = 0; offset < blockLength; offset += 8) {
+      int bytes = (blockLength - offset < 8) ? blockLength - offset : 8;
+      uint64_t planes[N] = {0};
+      
+#pragma GCC unroll 16
+      for (int k = 0; k < N; k++) {
+        memcpy(&planes[k], in + k * blockLength + offset, bytes);
+      }
+      
+#if DECODER_STATS
+      if (counters != NULL) {
+        uint64_t valid = 0;
+        memset(&valid, 0xFF, bytes);
+        countVotes(planes, valid, counters);
+      }
+#else
+      (void)counters;
+#endif
+      
+      uint64_t decoded = majority(planes);
+      memcpy(out + offset, &decoded, bytes);
+    }
+  }
+};
+
+/**
+ * Clase que implementa un codificador y decodificador de repetición.
+ * Permite codificar mensajes repitiendo cada bit n veces y decodificarlos
+ * mediante un sistema de votación por mayoría.
+ *
+ * El grado se elige en tiempo de ejecución: para los grados 3, 5, 7 y 9 se usa la versión
+ * especializada FixedRepetitionCode<N> y para el resto la implementación bit a bit
+ * GenericRepetitionCode.
+ *
+ * Admite dos disposiciones de las copias:
+ * - LAYOUT_BIT: cada bit se repite n veces seguidas (disposición original).
+ * - LAYOUT_BLOCK: el bloque completo se repite n veces. Las copias de un mismo bit quedan
+ *   separadas la longitud del bloque, así que una ráfaga de errores solo afecta a una copia,
+ *   y codificar y decodificar no requiere mover bits de sitio.
+ */
+class RepetitionCode {
+public:
+  // Disposición de las copias en el mensaje codificado
+  enum Layout {
+    LAYOUT_BIT,  // Cada bit se repite n veces seguidas
+    LAYOUT_BLOCK // El bloque completo se repite n veces
+  };
+  
+private:
+  int repetitionDegree; // Grado de repetición (número de veces que se repite cada bit)
+  Layout layout;        // Disposición de las copias
+  GenericRepetitionCode genericCoder; // Implementación para los grados no especializados
+#if DECODER_STATS
+  DecoderStats<RepetitionCounters> stats; // Contadores de la votación, uno por hilo
+#endif
+  
+  /**
+   * Método auxiliar que devuelve los contadores del hilo actual
+   * @return Contadores del hilo, o NULL si DECODER_STATS está a 0
+   */
+  RepetitionCounters *localCounters() {
+#if DECODER_STATS
+    return &stats.local();
+#else
+    return NULL;
+#endif
+  }
+  
+  /**
+   * Método auxiliar que codifica con disposición por bloques
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void encodeBlocks(unsigned char *in, unsigned char *out, int length) {
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::encodeBlocks(in, out, length);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::encodeBlocks(in, out, length);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::encodeBlocks(in, out, length);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::encodeBlocks(in, out, length);
+        break;
+      default:
+        GenericRepetitionCode::encodeBlocks(in, out, length, repetitionDegree);
+        break;
+    }
+  }
+  
+  /**
+   * Método auxiliar que decodifica con disposición por bloques
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decodeBlocks(unsigned char *in, unsigned char *out, int length) {
+    RepetitionCounters *counters = localCounters();
+    
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::decodeBlocks(in, out, length, counters);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::decodeBlocks(in, out, length, counters);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::decodeBlocks(in, out, length, counters);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::decodeBlocks(in, out, length, counters);
+        break;
+      default:
+        GenericRepetitionCode::decodeBlocks(in, out, length, repetitionDegree, counters);
+        break;
+    }
+  }
+  
+public:
+  /**
+   * Constructor de la clase
+   * @param n Grado de repetición (número de veces que se repite cada bit)
+   * @param codeLayout Disposición de las copias (por defecto, bit a bit)
+   */
+  RepetitionCode(int n, Layout codeLayout = LAYOUT_BIT) : genericCoder(n) {
+    repetitionDegree = n;
+    layout = codeLayout;
+  }
+  
+  /**
+   * Método para establecer el grado de repetición
+   * @param n Nuevo grado de repetición
+   */
+  void setRepetitionDegree(int n) {
+    repetitionDegree = n;
+    genericCoder.setRepetitionDegree(n);
+  }
+  
+  /**
+   * Método para obtener el grado de repetición actual
+   * @return Grado de repetición
+   */
+  int getRepetitionDegree() {
+    return repetitionDegree;
+  }
+  
+  /**
+   * Método para establecer la disposición de las copias
+   * @param codeLayout Nueva disposición
+   */
+  void setLayout(Layout codeLayout) {
+    layout = codeLayout;
+  }
+  
+  /**
+   * Método para obtener la disposición de las copias
+   * @return Disposición actual
+   */
+  Layout getLayout() {
+    return layout;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje codificado en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud del mensaje codificado en bytes
+   */
+  int getEncodedLength(int originalLength) {
+    if (layout == LAYOUT_BLOCK) {
+      return originalLength * repetitionDegree; // n copias completas del bloque
+    }
+    return (originalLength * 8 * repetitionDegree + 7) / 8; // Redondeo hacia arriba
+  }
+  
+  /**
+   * Método para codificar un mensaje utilizando repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void encode(unsigned char *in, unsigned char *out, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      encodeBlocks(in, out, length);
+      return;
+    }
+    
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::encode(in, out, length);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::encode(in, out, length);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::encode(in, out, length);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::encode(in, out, length);
+        break;
+      default:
+        genericCoder.encode(in, out, length);
+        break;
+    }
+  }
+  
+  /**
+   * Método para decodificar un mensaje codificado con repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decode(unsigned char *in, unsigned char *out, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      decodeBlocks(in, out, length);
+      return;
+    }
+    
+    RepetitionCounters *counters = localCounters();
+    
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::decode(in, out, length, counters);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::decode(in, out, length, counters);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::decode(in, out, length, counters);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::decode(in, out, length, counters);
+        break;
+      default:
+        GenericRepetitionCode::decodeBits(in, out, length, repetitionDegree, counters);
+        break;
+    }
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método para obtener los contadores de todas las votaciones de decode desde la última
+   * llamada a resetStats (sumando los de todos los hilos)
+   * @return Votaciones unánimes y divididas
+   */
+  RepetitionCounters getStats() {
+    return stats.read();
+  }
+  
+  /**
+   * Método para poner a 0 los contadores
+   */
+  void resetStats() {
+    stats.reset();
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal a partir de las votaciones
+   * @return Estimación de f
+   */
+  float estimateChannelErrorRate() {
+    return stats.read().estimateErrorRate(repetitionDegree);
+  }
+#endif
+  
+  /**
+   * Método para decodificar un mensaje y obtener además la fiabilidad de cada bit
+   * decodificado: el margen de la votación (copias a 0 menos copias a 1), con el mismo
+   * convenio de signo que un LLR. Permite que una etapa posterior decodifique teniendo
+   * en cuenta qué bits son más dudosos.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param reliability Fiabilidad de cada bit decodificado (un int8_t por bit)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decodeSoft(unsigned char *in, unsigned char *out, int8_t *reliability, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      GenericRepetitionCode::decodeSoftBlocks(in, out, reliability, length, repetitionDegree);
+    } else {
+      GenericRepetitionCode::decodeSoftBits(in, out, reliability, length, repetitionDegree);
+    }
+  }
+  
+  /**
+   * Método para decodificar un mensaje recibido por un canal de borrado.
+   * La votación solo tiene en cuenta las copias que no se han borrado.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de bits que no se han podido recuperar
+   */
+  int decodeErasures(unsigned char *in, unsigned char *erasures, unsigned char *out, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      return GenericRepetitionCode::decodeErasuresBlocks(in, erasures, out, length, repetitionDegree);
+    }
+    return genericCoder.decodeErasures(in, erasures, out, length);
+  }
+};
+
+/**
+ * Clase que implementa un codificador y decodificador que combina Hamming y Repetición en serie.
+ * Primero aplica el código Hamming (7,4) y luego el código de repetición de grado Rn.
+ *
+ * Las dos etapas van fusionadas en una sola pasada y sin buffers intermedios: cada nibble
+ * se convierte directamente en su palabra código de 7 bits con cada bit repetido n veces
+ * (7 * n bits), y al decodificar cada grupo de 7 * n bits se vota y se corrige directamente
+ * hasta obtener el nibble. Con los grados que tienen FixedRepetitionCode (3, 5, 7 y 9) se
+ * trabaja por bloques de 8 palabras código (7 * n bytes), que caben en una palabra de 64 bits.
+ * El resultado es idéntico al de aplicar HammingCode y después RepetitionCode con
+ * disposición bit a bit.
+ *
+ * Además del decodificador en dos pasos (mayoría y después Hamming) tiene un decodificador
+ * de máxima verosimilitud, que no decide cada bit por separado: con los votos de las 7
+ * posiciones calcula la distancia a las 16 palabras código y elige la más cercana.
+ */
+class HammingRepetition {
+public:
+  // Decodificador que se usa en decode
+  enum DecodingMode {
+    DECODE_HARD, // Mayoría de cada bit y después corrección Hamming
+    DECODE_ML    // Máxima verosimilitud sobre las 16 palabras código
+  };
+  
+private:
+  // Grado máximo para el que una palabra código repetida cabe en 64 bits (7 * 9 = 63)
+  static const int MAX_TABLE_DEGREE = 9;
+  
+  int repetitionDegree; // Grado de repetición (número de veces que se repite cada bit)
+  DecodingMode decodingMode; // Decodificador que se usa en decode
+  uint64_t repeatedCodewords[16]; // Palabra código repetida de cada nibble (si n <= 9)
+  // Máscaras de las 16 palabras código: codewordMasks[j][v] vale -1 si el bit j (contando
+  // desde p1) de la palabra código del nibble v es 1 y 0 si no
+  int16_t codewordMasks[7][16];
+  
+  // Lector de bits de un vector empaquetado (el primer bit es el más significativo)
+  struct BitReader {
+    unsigned char *data; // Vector de entrada
+    int length;          // Longitud del vector en bytes
+    int byteIndex;       // Siguiente byte por cargar
+    uint64_t buffer;     // Bits cargados y pendientes de leer, alineados a la derecha
+    int bufferBits;      // Número de bits pendientes
+    
+    BitReader(unsigned char *in, int inLength) : data(in), length(inLength), byteIndex(0), buffer(0), bufferBits(0) {
+    }
+    
+    /**
+     * Método para leer los siguientes bits (a partir del final del vector se leen ceros)
+     * @param count Número de bits (como máximo 32)
+     * @return Bits leídos, alineados a la derecha
+     */
+    uint64_t read(int count) {
+      while (bufferBits < count) {
+        buffer = (buffer << 8) | (byteIndex < length ? data[byteIndex] : 0);
+        byteIndex++;
+        bufferBits += 8;
+      }
+      bufferBits -= count;
+      return (buffer >> bufferBits) & (((uint64_t)1 << count) - 1);
+    }
+  };
+  
+  // Escritor de bits en un vector empaquetado (el primer bit es el más significativo)
+  struct BitWriter {
+    unsigned char *data; // Vector de salida
+    int byteIndex;       // Siguiente byte por escribir
+    uint64_t buffer;     // Bits pendientes de escribir, alineados a la derecha
+    int bufferBits;      // Número de bits pendientes (menos de 8 entre llamadas)
+    
+    BitWriter(unsigned char *out) : data(out), byteIndex(0), buffer(0), bufferBits(0) {
+    }
+    
+    /**
+     * Método para añadir bits y escribir los bytes que se completan
+     * @param value Bits a escribir, alineados a la derecha
+     * @param count Número de bits (como máximo 32)
+     */
+    void write(uint64_t value, int count) {
+      buffer = (buffer << count) | value;
+      bufferBits += count;
+      while (bufferBits >= 8) {
+        bufferBits -= 8;
+        data[byteIndex++] = (unsigned char)(buffer >> bufferBits);
+      }
+    }
+    
+    /**
+     * Método para escribir el último byte incompleto, completado con ceros
+     */
+    void flush() {
+      if (bufferBits > 0) {
+        data[byteIndex++] = (unsigned char)(buffer << (8 - bufferBits));
+        bufferBits = 0;
+      }
+    }
+  };
+  
+  /**
+   * Método auxiliar que rellena repeatedCodewords para el grado de repetición actual
+   */
+  void buildTable() {
+    if (repetitionDegree > MAX_TABLE_DEGREE) {
+      return;
+    }
+    uint64_t copies = ((uint64_t)1 << repetitionDegree) - 1; // n unos seguidos
+    for (int nibble = 0; nibble < 16; nibble++) {
+      unsigned char codeword = HammingCode::encodeNibble(nibble);
+      uint64_t repeated = 0;
+      for (int j = 6; j >= 0; j--) {
+        repeated = (repeated << repetitionDegree) | (((codeword >> j) & 1) ? copies : 0);
+      }
+      repeatedCodewords[nibble] = repeated;
+    }
+  }
+  
+  /**
+   * Método auxiliar que rellena codewordMasks
+   */
+  void buildMasks() {
+    for (int j = 0; j < 7; j++) {
+      for (int nibble = 0; nibble < 16; nibble++) {
+        codewordMasks[j][nibble] = ((HammingCode::encodeNibble(nibble) >> (6 - j)) & 1) ? -1 : 0;
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que escribe un nibble codificado: 7 * n bits
+   * @param writer Escritor del mensaje codificado
+   * @param nibble Valor de 4 bits
+   */
+  void writeNibble(BitWriter &writer, unsigned char nibble) {
+    int n = repetitionDegree;
+    if (n <= MAX_TABLE_DEGREE) {
+      uint64_t repeated = repeatedCodewords[nibble];
+      if (7 * n > 32) {
+        writer.write(repeated >> 32, 7 * n - 32);
+        writer.write(repeated & 0xFFFFFFFFULL, 32);
+      } else {
+        writer.write(repeated, 7 * n);
+      }
+      return;
+    }
+    
+    // Grados grandes: cada bit de la palabra código se escribe n veces, de 32 en 32
+    unsigned char codeword = HammingCode::encodeNibble(nibble);
+    for (int j = 6; j >= 0; j--) {
+      uint64_t bits = ((codeword >> j) & 1) ? 0xFFFFFFFFULL : 0;
+      for (int left = n; left > 0; left -= 32) {
+        int count = (left < 32) ? left : 32;
+        writer.write(bits >> (32 - count), count);
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que lee un grupo de 7 * n bits y obtiene el nibble: cada bit de la
+   * palabra código se decide por mayoría entre sus n copias y después se corrige con Hamming
+   * @param reader Lector del mensaje codificado
+   * @return Nibble decodificado
+   */
+  unsigned char readNibble(BitReader &reader) {
+    int n = repetitionDegree;
+    unsigned char codeword = 0;
+    
+    if (n <= MAX_TABLE_DEGREE) {
+      uint64_t group;
+      if (7 * n > 32) {
+        group = reader.read(7 * n - 32) << 32;
+        group |= reader.read(32);
+      } else {
+        group = reader.read(7 * n);
+      }
+      uint64_t copies = ((uint64_t)1 << n) - 1;
+      for (int j = 6; j >= 0; j--) {
+        int ones = __builtin_popcountll((group >> (j * n)) & copies);
+        codeword |= (ones > n / 2) << j;
+      }
+    } else {
+      for (int j = 6; j >= 0; j--) {
+        int ones = 0;
+        for (int left = n; left > 0; left -= 32) {
+          ones += __builtin_popcountll(reader.read((left < 32) ? left : 32));
+        }
+        codeword |= (ones > n / 2) << j;
+      }
+    }
+    return HammingCode::decodeCodeword(codeword);
+  }
+  
+  /**
+   * Método auxiliar que codifica con un grado que tiene FixedRepetitionCode. Cada bloque de
+   * 4 bytes de entrada da 7 bytes de Hamming (8 palabras código), que se repiten con la
+   * tabla de FixedRepetitionCode<N> y dan 7 * N bytes de salida.
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  template <int N>
+  void encodeFixed(unsigned char *in, unsigned char *out, int length) {
+    int blocks = length / 4;
+    
+    for (int block = 0; block < blocks; block++) {
+      uint64_t buffer = 0;
+      for (int i = 0; i < 4; i++) {
+        unsigned char value = in[block * 4 + i];
+        buffer = (buffer << 14) | (HammingCode::encodeNibble(value >> 4) << 7) | HammingCode::encodeNibble(value & 0x0F);
+      }
+      unsigned char hammingBytes[7];
+      for (int k = 0; k < 7; k++) {
+        hammingBytes[k] = (unsigned char)(buffer >> (48 - 8 * k));
+      }
+      FixedRepetitionCode<N>::encode(hammingBytes, out + block * 7 * N, 7);
+    }
+    encodeTail(in + blocks * 4, out + blocks * 7 * N, length - blocks * 4);
+  }
+  
+  /**
+   * Método auxiliar que codifica nibble a nibble con cualquier grado
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void encodeTail(unsigned char *in, unsigned char *out, int length) {
+    BitWriter writer(out);
+    
+    for (int i = 0; i < length; i++) {
+      writeNibble(writer, in[i] >> 4);
+      writeNibble(writer, in[i] & 0x0F);
+    }
+    writer.flush();
+    
+    // El relleno de la última palabra Hamming también se repite: son todo ceros
+    int encodedLength = getEncodedLength(length);
+    for (int i = writer.byteIndex; i < encodedLength; i++) {
+      out[i] = 0;
+    }
+  }
+  
+  /**
+   * Método auxiliar que decodifica con un grado que tiene FixedRepetitionCode. Cada bloque
+   * de 7 * N bytes se vota con FixedRepetitionCode<N>::decodeGroups, que deja las 8
+   * palabras código en los 56 bits altos de una palabra de 64 bits, y se corrige con Hamming
+   * o, con máxima verosimilitud, con decodeMargins.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param codewords Número de palabras código Hamming a decodificar
+   */
+  template <int N>
+  void decodeFixed(unsigned char *in, unsigned char *out, int length, int codewords) {
+    int blocks = codewords / 8;
+    if (blocks > length / (7 * N)) {
+      blocks = length / (7 * N); // El último bloque puede estar incompleto
+    }
+    
+    for (int block = 0; block < blocks; block++) {
+      uint64_t bits = FixedRepetitionCode<N>::template decodeGroups<7>(in + block * 7 * N);
+      if (decodingMode == DECODE_HARD) {
+        for (int i = 0; i < 4; i++) {
+          unsigned char high = HammingCode::decodeCodeword((bits >> (57 - 14 * i)) & 0x7F);
+          unsigned char low = HammingCode::decodeCodeword((bits >> (50 - 14 * i)) & 0x7F);
+          out[block * 4 + i] = (high << 4) | low;
+        }
+        continue;
+      }
+      
+      // Máxima verosimilitud: si la mayoría ya da una palabra código es la más verosímil
+      // (ver decodeMargins); solo las demás se vuelven a leer para contar los votos
+      for (int k = 0; k < 8; k++) {
+        unsigned char hard = (bits >> (57 - 7 * k)) & 0x7F;
+        unsigned char nibble = HammingCode::decodeCodeword(hard);
+        if (HammingCode::encodeNibble(nibble) != hard) {
+          nibble = decodeGroupAt(in, length, (block * 56 + k * 7) * N);
+        }
+        if (k % 2 == 0) {
+          out[block * 4 + k / 2] = nibble << 4;
+        } else {
+          out[block * 4 + k / 2] |= nibble;
+        }
+      }
+    }
+    decodeTail(in + blocks * 7 * N, out + blocks * 4, length - blocks * 7 * N, codewords - blocks * 8);
+  }
+  
+  /**
+   * Método auxiliar que decodifica grupo a grupo con cualquier grado
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param codewords Número de palabras código Hamming a decodificar
+   */
+  void decodeTail(unsigned char *in, unsigned char *out, int length, int codewords) {
+    BitReader reader(in, length);
+    
+    for (int c = 0; c < codewords; c++) {
+      unsigned char nibble;
+      if (decodingMode == DECODE_ML) {
+        int16_t margins[7];
+        readMargins(reader, margins);
+        nibble = decodeMargins(margins);
+      } else {
+        nibble = readNibble(reader);
+      }
+      
+      // Las palabras pares van a la parte alta del byte y las impares a la parte baja
+      if (c % 2 == 0) {
+        out[c / 2] = nibble << 4;
+      } else {
+        out[c / 2] |= nibble;
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que lee un grupo de 7 * n bits y obtiene el margen de cada posición
+   * de la palabra código: copias a 0 menos copias a 1 (positivo si ganan los ceros)
+   * @param reader Lector del mensaje codificado
+   * @param margins Margen de cada una de las 7 posiciones (p1 primero)
+   */
+  void readMargins(BitReader &reader, int16_t *margins) {
+    int n = repetitionDegree;
+    
+    if (n <= MAX_TABLE_DEGREE) {
+      uint64_t group;
+      if (7 * n > 32) {
+        group = reader.read(7 * n - 32) << 32;
+        group |= reader.read(32);
+      } else {
+        group = reader.read(7 * n);
+      }
+      uint64_t copies = ((uint64_t)1 << n) - 1;
+      for (int j = 0; j < 7; j++) {
+        margins[j] = n - 2 * __builtin_popcountll((group >> ((6 - j) * n)) & copies);
+      }
+    } else {
+      for (int j = 0; j < 7; j++) {
+        int ones = 0;
+        for (int left = n; left > 0; left -= 32) {
+          ones += __builtin_popcountll(reader.read((left < 32) ? left : 32));
+        }
+        margins[j] = n - 2 * ones;
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que elige la palabra código más verosímil. La distancia de Hamming
+   * entre los 7 * n bits recibidos y la palabra x repetida es la suma de las copias a 1 más
+   * la suma de los márgenes de las posiciones en las que x vale 1, así que basta con sumar
+   * esos márgenes para las 16 palabras y quedarse con la menor. El bucle sobre las 16
+   * palabras no tiene saltos y el compilador lo puede vectorizar.
+   * @param margins Margen de cada una de las 7 posiciones (p1 primero)
+   * @return Nibble de la palabra código más cercana
+   */
+  unsigned char decodeMargins(const int16_t *margins) {
+    // Si la decisión bit a bit ya es una palabra código, también es la más verosímil: sus
+    // unos están justo en las posiciones de margen negativo, así que su suma es la mínima
+    unsigned char hard = 0;
+    for (int j = 0; j < 7; j++) {
+      hard = (hard << 1) | (margins[j] < 0);
+    }
+    unsigned char hardNibble = HammingCode::decodeCodeword(hard);
+    if (HammingCode::encodeNibble(hardNibble) == hard) {
+      return hardNibble;
+    }
+    
+    int16_t scores[16] = {0};
+    for (int j = 0; j < 7; j++) {
+      for (int nibble = 0; nibble < 16; nibble++) {
+        scores[nibble] += margins[j] & codewordMasks[j][nibble];
+      }
+    }
+    
+    unsigned char best = 0;
+    for (int nibble = 1; nibble < 16; nibble++) {
+      if (scores[nibble] < scores[best]) {
+        best = nibble;
+      }
+    }
+    return best;
+  }
+  
+  /**
+   * Método auxiliar que decide por máxima verosimilitud la palabra código que empieza en
+   * un bit cualquiera del mensaje codificado
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param bitOffset Posición del primer bit del grupo de 7 * n bits
+   * @return Nibble de la palabra código más cercana
+   */
+  unsigned char decodeGroupAt(unsigned char *in, int length, int bitOffset) {
+    BitReader reader(in + bitOffset / 8, length - bitOffset / 8);
+    reader.read(bitOffset % 8);
+    int16_t margins[7];
+    readMargins(reader, margins);
+    return decodeMargins(margins);
+  }
+  
+public:
+  /**
+   * Constructor de la clase
+   * @param repetitionDegree Grado de repetición (número de veces que se repite cada bit)
+   * @param mode Decodificador que se usa en decode (por defecto, mayoría y Hamming)
+   */
+  HammingRepetition(int repetitionDegree, DecodingMode mode = DECODE_HARD) {
+    this->repetitionDegree = repetitionDegree;
+    decodingMode = mode;
+    buildTable();
+    buildMasks();
+  }
+  
+  /**
+   * Método para establecer el grado de repetición
+   * @param n Nuevo grado de repetición
+   */
+  void setRepetitionDegree(int n) {
+    repetitionDegree = n;
+    buildTable();
+  }
+  
+  /**
+   * Método para obtener el grado de repetición actual
+   * @return Grado de repetición
+   */
+  int getRepetitionDegree() {
+    return repetitionDegree;
+  }
+  
+  /**
+   * Método para establecer el decodificador que se usa en decode
+   * @param mode Nuevo decodificador
+   */
+  void setDecodingMode(DecodingMode mode) {
+    decodingMode = mode;
+  }
+  
+  /**
+   * Método para obtener el decodificador que se usa en decode
+   * @return Decodificador actual
+   */
+  DecodingMode getDecodingMode() {
+    return decodingMode;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje codificado en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud del mensaje codificado en bytes
+   */
+  int getEncodedLength(int originalLength) {
+    // Longitud después de aplicar Hamming (7 bits por nibble, redondeo hacia arriba)
+    int hammingLength = (originalLength * 2 * 7 + 7) / 8;
+    // Cada byte de Hamming se convierte en n bytes al aplicar repetición
+    return hammingLength * repetitionDegree;
+  }
+  
+  /**
+   * Método para codificar un mensaje utilizando Hamming seguido de repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void encode(unsigned char *in, unsigned char *out, int length) {
+    switch (repetitionDegree) {
+      case 3:
+        encodeFixed<3>(in, out, length);
+        break;
+      case 5:
+        encodeFixed<5>(in, out, length);
+        break;
+      case 7:
+        encodeFixed<7>(in, out, length);
+        break;
+      case 9:
+        encodeFixed<9>(in, out, length);
+        break;
+      default:
+        encodeTail(in, out, length);
+        break;
+    }
+  }
+  
+  /**
+   * Método para decodificar un mensaje codificado con repetición seguido de Hamming, con
+   * el decodificador elegido en setDecodingMode
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decode(unsigned char *in, unsigned char *out, int length) {
+    // Longitud del mensaje después de decodificar la repetición
+    int hammingLength = (length * 8) / repetitionDegree;
+    hammingLength = (hammingLength + 7) / 8; // Redondeo hacia arriba para obtener bytes
+    int codewords = (hammingLength * 8) / 7; // Palabras código Hamming completas
+    
+    switch (repetitionDegree) {
+      case 3:
+        decodeFixed<3>(in, out, length, codewords);
+        break;
+      case 5:
+        decodeFixed<5>(in, out, length, codewords);
+        break;
+      case 7:
+        decodeFixed<7>(in, out, length, codewords);
+        break;
+      case 9:
+        decodeFixed<9>(in, out, length, codewords);
+        break;
+      default:
+        decodeTail(in, out, length, codewords);
+        break;
+    }
+  }
+  
+  /**
+   * Método para mostrar información sobre un mensaje y su versión codificada
+   * @param original Mensaje original
+   * @param coded Mensaje codificado
+   * @param originalLength Longitud del mensaje original en bytes
+   * @param codedLength Longitud del mensaje codificado en bytes
+   */
+  void printInfo(unsigned char *original, unsigned char *coded, int originalLength, int codedLength) {
+    Serial.println("Mensaje original:");
+    printBinaryVector(original, originalLength);
+    
+    Serial.println("Mensaje codificado con Hamming+Repetición:");
+    printBinaryVector(coded, codedLength);
+    
+    Serial.print("Grado de repetición: ");
+    Serial.println(getRepetitionDegree());
+    Serial.print("Bits del mensaje original: ");
+    Serial.println(originalLength * 8);
+    Serial.print("Bits del mensaje codificado: ");
+    Serial.println(codedLength * 8);
+    
+    // Calcular y mostrar la tasa de código
+    float rate = (float)(originalLength * 8) / (codedLength * 8);
+    Serial.print("Tasa de código: ");
+    Serial.println(rate, 4);
+  }
+};
+
+/**
+ * Clase que añade a cada trama un CRC para que el receptor sepa si la ha recibido bien.
+ * Se coloca antes de codificar (añade el CRC al final del mensaje) y después de decodificar
+ * (lo comprueba y lo quita), así que no hace falta guardar el mensaje original para contar
+ * las tramas erróneas.
+ *
+ * Hay dos anchos: CRC-32 (el de Ethernet y ZIP, polinomio 0x04C11DB7 reflejado) y CRC-16/X-25
+ * (polinomio 0x1021 reflejado, valor inicial y final 0xFFFF). El CRC se añade con el byte
+ * menos significativo primero.
+ *
+ * En el ESP32 se usan las rutinas de CRC de la ROM (esp_rom_crc32_le y esp_rom_crc16_le).
+ * En el resto de casos se usa slice-by-8: ocho tablas de 256 entradas generadas en tiempo de
+ * compilación permiten procesar 8 bytes por iteración con 8 consultas independientes.
+ */
+class CrcFrame {
+public:
+  // Ancho del CRC
+  enum Width {
+    CRC_16, // CRC-16/X-25 (2 bytes)
+    CRC_32  // CRC-32 (4 bytes)
+  };
+  
+private:
+  static const uint32_t CRC32_POLYNOMIAL = 0xEDB88320; // 0x04C11DB7 reflejado
+  static const uint32_t CRC16_POLYNOMIAL = 0x8408;     // 0x1021 reflejado
+  
+  // Tablas de slice-by-8: entries[k][b] es el CRC (sin valores inicial ni final) del byte b
+  // seguido de k bytes a cero
+  struct SliceTables {
+    uint32_t entries[8][256];
+    
+    constexpr SliceTables(uint32_t polynomial) : entries() {
+      for (int b = 0; b < 256; b++) {
+        uint32_t crc = b;
+        for (int i = 0; i < 8; i++) {
+          crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+        }
+        entries[0][b] = crc;
+      }
+      for (int k = 1; k < 8; k++) {
+        for (int b = 0; b < 256; b++) {
+          uint32_t previous = entries[k - 1][b];
+          entries[k][b] = (previous >> 8) ^ entries[0][previous & 0xFF];
+        }
+      }
+    }
+  };
+  
+  // Se definen después de la clase, cuando SliceTables ya está completa
+  static const SliceTables CRC32_TABLES;
+  static const SliceTables CRC16_TABLES;
+  
+  Width width;         // Ancho del CRC
+  int crcLength;       // Bytes del CRC
+  long passedFrames;   // Tramas que han pasado la comprobación
+  long failedFrames;   // Tramas que no la han pasado
+  
+  // Lee 4 bytes en orden little endian
+  static uint32_t readLittleEndian(const unsigned char *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+  }
+  
+  /**
+   * Método auxiliar que actualiza un CRC reflejado de hasta 32 bits con slice-by-8
+   * @param tables Tablas del polinomio
+   * @param crc CRC acumulado (ya con el valor inicial aplicado)
+   * @param data Datos
+   * @param length Longitud de los datos en bytes
+   * @return CRC acumulado
+   */
+  static uint32_t updateSliceBy8(const SliceTables &tables, uint32_t crc, const unsigned char *data, int length) {
+    const uint32_t (*t)[256] = tables.entries;
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+      uint32_t low = crc ^ readLittleEndian(data + i);
+      uint32_t high = readLittleEndian(data + i + 4);
+      crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+            t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    for (; i < length; i++) {
+      crc = (crc >> 8) ^ t[0][(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+  }
+  
+  // Calcula el CRC de los datos con el ancho configurado
+  uint32_t compute(const unsigned char *data, int length) {
+    return width == CRC_16 ? crc16(data, length) : crc32(data, length);
+  }
+  
+public:
+  /**
+   * Constructor de la clase
+   * @param crcWidth Ancho del CRC (por defecto, CRC-32)
+   */
+  CrcFrame(Width crcWidth = CRC_32) {
+    width = crcWidth;
+    crcLength = (width == CRC_16) ? 2 : 4;
+    passedFrames = 0;
+    failedFrames = 0;
+  }
+  
+  /**
+   * Calcula el CRC-32 de un vector
+   * @param data Datos
+   * @param length Longitud de los datos en bytes
+   * @return CRC-32
+   */
+  static uint32_t crc32(const unsigned char *data, int length) {
+#if CRC_USE_ROM
+    return esp_rom_crc32_le(0, data, length);
+#else
+    return ~updateSliceBy8(CRC32_TABLES, 0xFFFFFFFF, data, length);
+#endif
+  }
+  
+  /**
+   * Calcula el CRC-16/X-25 de un vector
+   * @param data Datos
+   * @param length Longitud de los datos en bytes
+   * @return CRC-16
+   */
+  static uint16_t crc16(const unsigned char *data, int length) {
+#if CRC_USE_ROM
+    return esp_rom_crc16_le(0, data, length);
+#else
+    return ~updateSliceBy8(CRC16_TABLES, 0xFFFF, data, length) & 0xFFFF;
+#endif
+  }
+  
+  /**
+   * Método para obtener los bytes que ocupa el CRC
+   * @return Bytes del CRC
+   */
+  int getCrcLength() {
+    return crcLength;
+  }
+  
+  /**
+   * Método para calcular la longitud de la trama en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud de la trama (mensaje y CRC) en bytes
+   */
+  int getEncodedLength(int originalLength) {
+    return originalLength + crcLength;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje contenido en una trama
+   * @param encodedLength Longitud de la trama en bytes
+   * @return Longitud del mensaje en bytes
+   */
+  int getDecodedLength(int encodedLength) {
+    return encodedLength > crcLength ? encodedLength - crcLength : 0;
+  }
+  
+  /**
+   * Método para formar una trama: copia el mensaje y le añade el CRC.
+   * La entrada y la salida pueden ser el mismo vector (con sitio para el CRC).
+   * @param in Mensaje
+   * @param out Trama
+   * @param length Longitud del mensaje en bytes
+   */
+  void encode(unsigned char *in, unsigned char *out, int length) {
+    uint32_t crc = compute(in, length);
+    memmove(out, in, length);
+    for (int i = 0; i < crcLength; i++) {
+      out[length + i] = (crc >> (8 * i)) & 0xFF;
+    }
+  }
+  
+  /**
+   * Método para comprobar una trama sin copiarla
+   * @param in Trama
+   * @param length Longitud de la trama en bytes
+   * @return true si el CRC coincide
+   */
+  bool check(unsigned char *in, int length) {
+    if (length < crcLength) {
+      return false;
     }
+    int dataLength = length - crcLength;
+    uint32_t received = 0;
+    for (int i = 0; i < crcLength; i++) {
+      received |= (uint32_t)in[dataLength + i] << (8 * i);
+    }
+    return compute(in, dataLength) == received;
+  }
+  
+  /**
+   * Método para comprobar una trama y extraer el mensaje. Cuenta la trama como correcta o
+   * errónea; los contadores no se pueden actualizar desde varios hilos a la vez, pero el valor
+   * devuelto sí es fiable en cualquier caso.
+   * @param in Trama
+   * @param out Mensaje
+   * @param length Longitud de la trama en bytes
+   * @return true si el CRC coincide
+   */
+  bool decode(unsigned char *in, unsigned char *out, int length) {
+    bool passed = check(in, length);
+    memmove(out, in, getDecodedLength(length));
+    if (passed) {
+      passedFrames++;
+    } else {
+      failedFrames++;
+    }
+    return passed;
+  }
+  
+  /**
+   * Método para obtener el número de tramas que han pasado la comprobación
+   * @return Tramas correctas
+   */
+  long getPassedFrames() {
+    return passedFrames;
+  }
+  
+  /**
+   * Método para obtener el número de tramas que no han pasado la comprobación
+   * @return Tramas erróneas
+   */
+  long getFailedFrames() {
+    return failedFrames;
+  }
+  
+  /**
+   * Método para poner a cero los contadores de tramas
+   */
+  void resetCounters() {
+    passedFrames = 0;
+    failedFrames = 0;
   }
 };
 
+constexpr CrcFrame::SliceTables CrcFrame::CRC32_TABLES = CrcFrame::SliceTables(CrcFrame::CRC32_POLYNOMIAL);
+constexpr CrcFrame::SliceTables CrcFrame::CRC16_TABLES = CrcFrame::SliceTables(CrcFrame::CRC16_POLYNOMIAL);
+
 /**
- * Clase que implementa un codificador y decodificador de repetición.
- * Permite codificar mensajes repitiendo cada bit n veces y decodificarlos
- * mediante un sistema de votación por mayoría.
+ * Generador pseudoaleatorio xoshiro256** de 64 bits.
+ * Es rápido, reproducible a partir de una semilla explícita y permite saltar 2^128
+ * valores hacia delante, de modo que cada trabajador de una simulación puede usar
+ * una subsecuencia propia que no se solapa con las de los demás.
  */
-class RepetitionCode {
+class Xoshiro256 {
 private:
-  int repetitionDegree; // Grado de repetición (número de veces que se repite cada bit)
+  uint64_t state[4]; // Estado interno del generador
+  
+  // Rotación a la izquierda de 64 bits
+  static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+  
+  // Paso del generador SplitMix64, usado para expandir la semilla al estado completo
+  static uint64_t splitMix64(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  
+  // Avanza el estado según el polinomio de salto indicado
+  void applyJump(const uint64_t *polynomial) {
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+      for (int b = 0; b < 64; b++) {
+        if (polynomial[i] & ((uint64_t)1 << b)) {
+          s0 ^= state[0];
+          s1 ^= state[1];
+          s2 ^= state[2];
+          s3 ^= state[3];
+        }
+        next();
+      }
+    }
+    state[0] = s0;
+    state[1] = s1;
+    state[2] = s2;
+    state[3] = s3;
+  }
   
 public:
   /**
    * Constructor de la clase
-   * @param n Grado de repetición (número de veces que se repite cada bit)
+   * @param seed Semilla de 64 bits
    */
-  RepetitionCode(int n) {
-    repetitionDegree = n;
+  Xoshiro256(uint64_t seed = 0) {
+    setSeed(seed);
   }
   
   /**
-   * Método para establecer el grado de repetición
-   * @param n Nuevo grado de repetición
+   * Reinicia el generador a partir de una semilla de 64 bits
+   * @param seed Semilla
    */
-  void setRepetitionDegree(int n) {
-    repetitionDegree = n;
+  void setSeed(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+      state[i] = splitMix64(seed);
+    }
   }
   
   /**
-   * Método para obtener el grado de repetición actual
-   * @return Grado de repetición
+   * Genera el siguiente valor de 64 bits
+   * @return Valor aleatorio de 64 bits
    */
-  int getRepetitionDegree() {
-    return repetitionDegree;
+  uint64_t next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+    
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    
+    return result;
   }
   
   /**
-   * Método para calcular la longitud del mensaje codificado en bytes
-   * @param originalLength Longitud del mensaje original en bytes
-   * @return Longitud del mensaje codificado en bytes
+   * Genera el siguiente valor de 32 bits (los 32 bits altos, que son los de mejor calidad)
+   * @return Valor aleatorio de 32 bits
    */
-  int getEncodedLength(int originalLength) {
-    return (originalLength * 8 * repetitionDegree + 7) / 8; // Redondeo hacia arriba
+  uint32_t next32() {
+    return (uint32_t)(next() >> 32);
   }
   
   /**
-   * Método para codificar un mensaje utilizando repetición
-   * @param in Vector binario de entrada empaquetado en unsigned char
-   * @param out Vector binario de salida empaquetado en unsigned char
-   * @param length Longitud del vector de entrada en bytes
+   * Avanza el generador 2^128 valores. Llamándolo k veces sobre la misma semilla
+   * se obtiene la k-ésima subsecuencia independiente.
    */
-  void encode(unsigned char *in, unsigned char *out, int length) {
-    int outBitIndex = 0; // Índice del bit actual en el vector de salida
+  void jump() {
+    static const uint64_t JUMP[4] = {
+      0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    applyJump(JUMP);
+  }
+  
+  /**
+   * Avanza el generador 2^192 valores, para repartir subsecuencias entre grupos de trabajadores.
+   */
+  void longJump() {
+    static const uint64_t LONG_JUMP[4] = {
+      0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL
+    };
+    applyJump(LONG_JUMP);
+  }
+};
+
+/**
+ * Clase que simula un canal ruidoso para comunicaciones binarias.
+ * Permite configurar el porcentaje de ruido que se introducirá en los mensajes.
+ *
+ * Dispone de dos modos de funcionamiento:
+ * - MODE_BIT: genera un número aleatorio por cada bit y lo compara con f a resolución completa.
+ * - MODE_WORD: construye máscaras de error de 64 bits de una vez y las aplica con XOR
+ *   palabra a palabra. Para f bajas se usa muestreo geométrico de huecos (se salta
+ *   directamente al siguiente bit erróneo) y para f altas se construye la máscara
+ *   bit a bit como combinación AND/OR de palabras aleatorias (Bernoulli por palabra).
+ *
+ * Los números aleatorios salen de un generador xoshiro256** propio del canal, con semilla
+ * explícita de 64 bits y selección de subsecuencia, para poder repetir exactamente una
+ * simulación y repartirla entre varios trabajadores sin solapamiento.
+ */
+class NoisyChannel {
+public:
+  // Modos de generación de errores
+  enum Mode {
+    MODE_BIT,  // Un número aleatorio por bit
+    MODE_WORD  // Máscaras de error de 64 bits
+  };
+  
+private:
+  // Por debajo de esta probabilidad compensa el muestreo geométrico de huecos
+  static constexpr float GAP_SAMPLING_MAX_NOISE = 0.1;
+  // Bits de precisión con los que se representa f en el modo Bernoulli por palabra
+  static const int BERNOULLI_PRECISION = 24;
+  
+  float noisePercentage; // Porcentaje de ruido (entre 0 y 1)
+  Mode mode;             // Modo de generación de errores
+  
+  Xoshiro256 generator;  // Generador pseudoaleatorio del canal
+  uint64_t seed;         // Semilla con la que se inicializó el generador
+  uint64_t bitThreshold; // f escalada a 2^32, para comparar en el modo MODE_BIT
+  
+  // Estado del generador de máscaras (modo MODE_WORD)
+  bool useGapSampling;         // true si se usa muestreo geométrico de huecos
+  float inverseLogNoNoise;     // 1 / ln(1 - f), para muestrear la longitud de los huecos
+  uint32_t bitsToNextError;    // Bits correctos que faltan hasta el siguiente error
+  uint32_t bernoulliThreshold; // f cuantizada con BERNOULLI_PRECISION bits
+  int bernoulliFirstRound;     // Primer bit no nulo de bernoulliThreshold
+  
+  // Obtiene una semilla de la fuente de entropía del hardware (solo al construir el canal)
+  static uint64_t hardwareSeed() {
+#if defined(ESP32)
+    return ((uint64_t)esp_random() << 32) | esp_random();
+#else
+    return ((uint64_t)analogRead(0) << 32) ^ micros();
+#endif
+  }
+  
+  // Devuelve 32 bits aleatorios
+  uint32_t nextRandom32() {
+    return generator.next32();
+  }
+  
+  // Devuelve 64 bits aleatorios
+  uint64_t nextRandom64() {
+    return generator.next();
+  }
+  
+  // Muestrea el número de bits correctos antes del siguiente error (distribución geométrica)
+  uint32_t sampleGap() {
+    // u en (0, 1], nunca 0 para que el logaritmo esté definido
+    float u = (nextRandom32() + 1.0f) * (1.0f / 4294967296.0f);
+    float gap = logf(u) * inverseLogNoNoise;
+    if (gap >= 4294967295.0f) {
+      return 0xFFFFFFFF;
+    }
+    return (uint32_t)gap;
+  }
+  
+  // Recalcula los parámetros del generador de máscaras a partir de noisePercentage
+  void updateMaskParameters() {
+    bitThreshold = (uint64_t)((double)noisePercentage * 4294967296.0);
+    
+    useGapSampling = noisePercentage > 0 && noisePercentage < GAP_SAMPLING_MAX_NOISE;
+    if (useGapSampling) {
+      inverseLogNoNoise = 1.0f / logf(1.0f - noisePercentage);
+      bitsToNextError = sampleGap();
+    }
+    
+    bernoulliThreshold = (uint32_t)(noisePercentage * (1 << BERNOULLI_PRECISION) + 0.5f);
+    bernoulliFirstRound = 0;
+    if (bernoulliThreshold != 0) {
+      // Los bits nulos menos significativos no aportan nada (0 AND r = 0)
+      while (((bernoulliThreshold >> bernoulliFirstRound) & 1) == 0) {
+        bernoulliFirstRound++;
+      }
+    }
+  }
+  
+  // Envío bit a bit (un número aleatorio por bit)
+  int sendPacketBitwise(unsigned char *input, unsigned char *output, int length) {
+    int flippedBits = 0;
     
     // Recorrer cada byte del vector de entrada
     for (int i = 0; i < length; i++) {
+      // Inicializar el byte de salida con el valor del byte de entrada
+      output[i] = input[i];
+      
       // Procesar cada bit del byte actual
-      for (int j = 7; j >= 0; j--) {
-        // Extraer el bit j-ésimo del byte i-ésimo
-        unsigned char bit = (in[i] >> j) & 1;
-        
-        // Repetir el bit n veces
-        for (int k = 0; k < repetitionDegree; k++) {
-          // Calcular el índice del byte de salida donde se colocará el bit repetido
-          int outByteIndex = outBitIndex / 8;
-          // Calcular la posición del bit dentro del byte de salida
-          int outBitPosition = 7 - (outBitIndex % 8);
-          
-          // Si estamos en un nuevo byte, inicializarlo a 0
-          if (outBitPosition == 7) {
-            out[outByteIndex] = 0;
-          }
-          
-          // Colocar el bit en la posición correspondiente del byte de salida
-          out[outByteIndex] |= (bit << outBitPosition);
-          
-          // Incrementar el índice del bit de salida
-          outBitIndex++;
+      for (int j = 0; j < 8; j++) {
+        // Si el número aleatorio de 32 bits es menor que f * 2^32,
+        // invertir el bit correspondiente en el byte de salida
+        if (nextRandom32() < bitThreshold) {
+          // Invertir el bit j-ésimo usando XOR con una máscara
+          output[i] ^= (1 << j);
+          flippedBits++;
         }
       }
     }
+    return flippedBits;
   }
   
-  /**
-   * Método para decodificar un mensaje codificado con repetición
-   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
-   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
-   * @param length Longitud del vector de entrada en bytes
-   */
-  void decode(unsigned char *in, unsigned char *out, int length) {
-    int inBitIndex = 0;  // Índice del bit actual en el vector de entrada
-    int outBitIndex = 0; // Índice del bit actual en el vector de salida
-    
-    // Inicializar el vector de salida a ceros
-    int outLength = (length * 8) / repetitionDegree; // Número total de bits en el mensaje original
-    int outBytes = (outLength + 7) / 8; // Número de bytes necesarios para almacenar el mensaje original
+  // Envío palabra a palabra con máscaras de error de 64 bits
+  int sendPacketWordwise(unsigned char *input, unsigned char *output, int length) {
+    int flippedBits = 0;
+    int i = 0;
     
-    for (int i = 0; i < outBytes; i++) {
-      out[i] = 0;
+    // Aplicar una máscara por cada bloque completo de 8 bytes
+    for (; i + 8 <= length; i += 8) {
+      uint64_t word;
+      uint64_t mask = nextErrorMask();
+      memcpy(&word, input + i, 8);
+      word ^= mask;
+      memcpy(output + i, &word, 8);
+      flippedBits += __builtin_popcountll(mask);
     }
     
-    // Procesar cada grupo de n bits repetidos
-    while (inBitIndex < length * 8) {
-      int countOnes = 0; // Contador de unos en el grupo actual
-      
-      // Contar cuántos unos hay en el grupo de n bits
-      for (int k = 0; k < repetitionDegree && inBitIndex < length * 8; k++) {
-        // Calcular el índice del byte de entrada y la posición del bit
-        int inByteIndex = inBitIndex / 8;
-        int inBitPosition = 7 - (inBitIndex % 8);
-        
-        // Extraer el bit de la posición correspondiente
-        unsigned char bit = (in[inByteIndex] >> inBitPosition) & 1;
-        
-        // Incrementar el contador si el bit es 1
-        if (bit == 1) {
-          countOnes++;
-        }
-        
-        // Avanzar al siguiente bit de entrada
-        inBitIndex++;
+    // Bytes restantes: se usan los bytes bajos de una última máscara
+    if (i < length) {
+      uint64_t mask = nextErrorMask();
+      for (; i < length; i++) {
+        unsigned char byteMask = mask & 0xFF;
+        output[i] = input[i] ^ byteMask;
+        flippedBits += __builtin_popcount(byteMask);
+        mask >>= 8;
       }
-      
-      // Determinar el bit original mediante votación por mayoría
-      unsigned char decodedBit = (countOnes > repetitionDegree / 2) ? 1 : 0;
-      
-      // Calcular el índice del byte de salida y la posición del bit
-      int outByteIndex = outBitIndex / 8;
-      int outBitPosition = 7 - (outBitIndex % 8);
-      
-      // Colocar el bit decodificado en la posición correspondiente del byte de salida
-      out[outByteIndex] |= (decodedBit << outBitPosition);
-      
-      // Avanzar al siguiente bit de salida
-      outBitIndex++;
     }
+    return flippedBits;
   }
-};
-
-/**
- * Clase que implementa un codificador y decodificador que combina Hamming y Repetición en serie.
- * Primero aplica el código Hamming (7,4) y luego el código de repetición de grado Rn.
- */
-class HammingRepetition {
-private:
-  HammingCode hammingCoder; // Codificador/decodificador Hamming
-  RepetitionCode repetitionCoder; // Codificador/decodificador de repetición
   
 public:
   /**
-   * Constructor de la clase
-   * @param repetitionDegree Grado de repetición (número de veces que se repite cada bit)
+   * Constructor de la clase NoisyChannel.
+   * La semilla se toma de la fuente de entropía del hardware.
+   * @param noise Porcentaje de ruido que se introducirá en los mensajes (entre 0 y 1)
+   * @param channelMode Modo de generación de errores (por defecto, máscaras por palabra)
    */
-  HammingRepetition(int repetitionDegree) : repetitionCoder(repetitionDegree) {
-    // Inicialización de objetos en la lista de inicialización
+  NoisyChannel(float noise, Mode channelMode = MODE_WORD) {
+    // Asegurar que el porcentaje de ruido esté entre 0 y 1
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    mode = channelMode;
+    setSeed(hardwareSeed());
   }
   
   /**
-   * Método para establecer el grado de repetición
-   * @param n Nuevo grado de repetición
+   * Constructor de la clase NoisyChannel con semilla explícita (simulaciones reproducibles).
+   * @param noise Porcentaje de ruido que se introducirá en los mensajes (entre 0 y 1)
+   * @param channelSeed Semilla de 64 bits del generador
+   * @param channelMode Modo de generación de errores (por defecto, máscaras por palabra)
    */
-  void setRepetitionDegree(int n) {
-    repetitionCoder.setRepetitionDegree(n);
+  NoisyChannel(float noise, uint64_t channelSeed, Mode channelMode = MODE_WORD) {
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    mode = channelMode;
+    setSeed(channelSeed);
   }
   
   /**
-   * Método para obtener el grado de repetición actual
-   * @return Grado de repetición
+   * Envía un paquete a través del canal ruidoso.
+   * La entrada y la salida pueden ser el mismo vector.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
    */
-  int getRepetitionDegree() {
-    return repetitionCoder.getRepetitionDegree();
+  int sendPacket(unsigned char *input, unsigned char *output, int length) {
+    if (mode == MODE_BIT) {
+      return sendPacketBitwise(input, output, length);
+    }
+    return sendPacketWordwise(input, output, length);
   }
   
   /**
-   * Método para calcular la longitud del mensaje codificado en bytes
-   * @param originalLength Longitud del mensaje original en bytes
-   * @return Longitud del mensaje codificado en bytes
+   * Recibe un paquete a través del canal ruidoso.
+   * Esta función es idéntica a sendPacket, ya que el canal es simétrico.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
    */
-  int getEncodedLength(int originalLength) {
-    // Primero calculamos la longitud después de aplicar Hamming
-    int hammingLength = hammingCoder.getEncodedLength(originalLength);
-    // Luego calculamos la longitud después de aplicar repetición
-    return repetitionCoder.getEncodedLength(hammingLength);
+  int receivePacket(unsigned char *input, unsigned char *output, int length) {
+    // En un canal simétrico, enviar y recibir son operaciones equivalentes
+    return sendPacket(input, output, length);
   }
   
   /**
-   * Método para codificar un mensaje utilizando Hamming seguido de repetición
-   * @param in Vector binario de entrada empaquetado en unsigned char
-   * @param out Vector binario de salida empaquetado en unsigned char
-   * @param length Longitud del vector de entrada en bytes
+   * Genera una máscara de error de 64 bits donde cada bit vale 1 con probabilidad f.
+   * Es la base del modo MODE_WORD y la usan también otros canales para construir sus errores.
+   * @return Máscara de error
    */
-  void encode(unsigned char *in, unsigned char *out, int length) {
-    // Calcular la longitud del mensaje codificado con Hamming
-    int hammingLength = hammingCoder.getEncodedLength(length);
-    
-    // Buffer temporal para almacenar el resultado de la codificación Hamming
-    unsigned char *hammingOut = new unsigned char[hammingLength];
-    
-    // Aplicar codificación Hamming
-    hammingCoder.encode(in, hammingOut, length);
+  uint64_t nextErrorMask() {
+    if (useGapSampling) {
+      // Saltar directamente de un error al siguiente
+      uint64_t mask = 0;
+      while (bitsToNextError < 64) {
+        mask |= (uint64_t)1 << bitsToNextError;
+        uint32_t gap = sampleGap();
+        bitsToNextError = (gap > 0xFFFFFFFF - 65) ? 0xFFFFFFFF : bitsToNextError + 1 + gap;
+      }
+      bitsToNextError -= 64;
+      return mask;
+    }
     
-    // Aplicar codificación por repetición al resultado de Hamming
-    repetitionCoder.encode(hammingOut, out, hammingLength);
+    if (bernoulliThreshold == 0) {
+      return 0;
+    }
+    if (bernoulliThreshold >= (1u << BERNOULLI_PRECISION)) {
+      return ~(uint64_t)0;
+    }
     
-    // Liberar memoria del buffer temporal
-    delete[] hammingOut;
+    // Comparar cada bit con la expansión binaria de f, del bit menos significativo al más
+    // significativo: un 1 en f combina con OR y un 0 combina con AND
+    uint64_t mask = 0;
+    for (int k = bernoulliFirstRound; k < BERNOULLI_PRECISION; k++) {
+      if ((bernoulliThreshold >> k) & 1) {
+        mask |= nextRandom64();
+      } else {
+        mask &= nextRandom64();
+      }
+    }
+    return mask;
   }
   
   /**
-   * Método para decodificar un mensaje codificado con repetición seguido de Hamming
-   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
-   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
-   * @param length Longitud del vector de entrada en bytes
+   * Obtiene el porcentaje de ruido configurado en el canal.
+   * @return Porcentaje de ruido (entre 0 y 1)
    */
-  void decode(unsigned char *in, unsigned char *out, int length) {
-    // Calcular la longitud del mensaje después de decodificar la repetición
-    int hammingLength = (length * 8) / repetitionCoder.getRepetitionDegree();
-    hammingLength = (hammingLength + 7) / 8; // Redondeo hacia arriba para obtener bytes
-    
-    // Buffer temporal para almacenar el resultado de la decodificación de repetición
-    unsigned char *repetitionOut = new unsigned char[hammingLength];
-    
-    // Aplicar decodificación de repetición
-    repetitionCoder.decode(in, repetitionOut, length);
-    
-    // Aplicar decodificación Hamming al resultado
-    hammingCoder.decode(repetitionOut, out, hammingLength);
-    
-    // Liberar memoria del buffer temporal
-    delete[] repetitionOut;
+  float getNoisePercentage() {
+    return noisePercentage;
   }
   
   /**
-   * Método para mostrar información sobre un mensaje y su versión codificada
-   * @param original Mensaje original
-   * @param coded Mensaje codificado
-   * @param originalLength Longitud del mensaje original en bytes
-   * @param codedLength Longitud del mensaje codificado en bytes
+   * Establece un nuevo porcentaje de ruido para el canal.
+   * @param noise Nuevo porcentaje de ruido (entre 0 y 1)
    */
-  void printInfo(unsigned char *original, unsigned char *coded, int originalLength, int codedLength) {
-    Serial.println("Mensaje original:");
-    printBinaryVector(original, originalLength);
-    
-    Serial.println("Mensaje codificado con Hamming+Repetición:");
-    printBinaryVector(coded, codedLength);
-    
-    Serial.print("Grado de repetición: ");
-    Serial.println(getRepetitionDegree());
-    Serial.print("Bits del mensaje original: ");
-    Serial.println(originalLength * 8);
-    Serial.print("Bits del mensaje codificado: ");
-    Serial.println(codedLength * 8);
-    
-    // Calcular y mostrar la tasa de código
-    float rate = (float)(originalLength * 8) / (codedLength * 8);
-    Serial.print("Tasa de código: ");
-    Serial.println(rate, 4);
+  void setNoisePercentage(float noise) {
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    updateMaskParameters();
+  }
+  
+  /**
+   * Obtiene el modo de generación de errores.
+   * @return Modo actual
+   */
+  Mode getMode() {
+    return mode;
+  }
+  
+  /**
+   * Establece el modo de generación de errores.
+   * @param channelMode Nuevo modo
+   */
+  void setMode(Mode channelMode) {
+    mode = channelMode;
+  }
+  
+  /**
+   * Reinicia el generador del canal con una semilla explícita.
+   * Dos canales con la misma semilla y configuración producen exactamente los mismos errores.
+   * @param channelSeed Semilla de 64 bits
+   */
+  void setSeed(uint64_t channelSeed) {
+    seed = channelSeed;
+    generator.setSeed(seed);
+    updateMaskParameters();
+  }
+  
+  /**
+   * Obtiene la semilla con la que se inicializó el generador.
+   * @return Semilla de 64 bits
+   */
+  uint64_t getSeed() {
+    return seed;
+  }
+  
+  /**
+   * Selecciona la subsecuencia aleatoria número streamIndex de la semilla actual.
+   * Cada subsecuencia está separada 2^128 valores de la siguiente, así que trabajadores
+   * con la misma semilla e índices distintos nunca comparten números aleatorios.
+   * @param streamIndex Índice de la subsecuencia (0 es la secuencia original)
+   */
+  void selectStream(int streamIndex) {
+    generator.setSeed(seed);
+    for (int i = 0; i < streamIndex; i++) {
+      generator.jump();
+    }
+    updateMaskParameters();
   }
 };
 
 /**
  * Función que simula un canal ruidoso.
+ * Mantiene un único canal entre llamadas, de modo que la semilla solo se inicializa una vez.
  * @param in Vector binario de entrada empaquetado en unsigned char
  * @param out Vector binario de salida empaquetado en unsigned char
  * @param l Longitud del vector en bytes
  * @param f Probabilidad de que un bit cambie de valor (entre 0 y 1)
+ * @return Número de bits invertidos por el canal
  */
-void noisyChannel(unsigned char *in, unsigned char *out, int l, float f) {
-  // Inicializar la semilla para la generación de números aleatorios
-  randomSeed(analogRead(0));
-  
-  // Recorrer cada byte del vector de entrada
-  for (int i = 0; i < l; i++) {
-    // Inicializar el byte de salida con el valor del byte de entrada
-    out[i] = in[i];
-    
-    // Procesar cada bit del byte actual
-    for (int j = 0; j < 8; j++) {
-      // Generar un número aleatorio entre 0 y 1
-      float r = random(0, 100) / 100.0;
-      
-      // Si el número aleatorio es menor que la probabilidad de error f,
-      // invertir el bit correspondiente en el byte de salida
-      if (r < f) {
-        // Invertir el bit j-ésimo usando XOR con una máscara
-        out[i] ^= (1 << j);
-      }
-    }
+int noisyChannel(unsigned char *in, unsigned char *out, int l, float f) {
+  static NoisyChannel channel(f);
+  
+  if (channel.getNoisePercentage() != f) {
+    channel.setNoisePercentage(f);
   }
+  return channel.sendPacket(in, out, l);
 }
 
 void setup() {
@@ -552,6 +3250,17 @@ void setup() {
     Serial.println("fallida. El mensaje contiene errores.");
   }
   
+  // Decodificar el mismo mensaje por máxima verosimilitud, que usa los votos de cada copia
+  // en lugar de decidir cada bit antes de corregir con Hamming
+  hammingRepCode.setDecodingMode(HammingRepetition::DECODE_ML);
+  hammingRepCode.decode(received, decoded, codedLength);
+  hammingRepCode.setDecodingMode(HammingRepetition::DECODE_HARD);
+  
+  Serial.println("\nMensaje decodificado por máxima verosimilitud:");
+  printBinaryVector(decoded, originalLength);
+  Serial.print("Decodificación correcta: ");
+  Serial.println(memcmp(original, decoded, originalLength) == 0 ? "Sí" : "No");
+  
   // Comparar con solo Hamming y solo Repetición
   Serial.println("\n=== Comparación con otros códigos ===");
   
@@ -571,6 +3280,33 @@ void setup() {
   Serial.println("\nTasa de código Hamming (7,4): 4/7 = " + String((float)4/7, 4));
   Serial.println("Tasa de código Repetición (R3): 1/3 = " + String((float)1/3, 4));
   Serial.println("Tasa de código Hamming+Repetición: " + String((float)(originalLength * 8) / (codedLength * 8), 4));
+  
+  // Trama con CRC-16: el receptor comprueba el mensaje sin tener que compararlo con el original
+  Serial.println("\n=== Trama con CRC-16 ===");
+  CrcFrame crcFrame(CrcFrame::CRC_16);
+  int frameLength = crcFrame.getEncodedLength(originalLength);
+  int frameCodedLength = hammingRepCode.getEncodedLength(frameLength);
+  unsigned char frame[frameLength];
+  unsigned char frameCoded[frameCodedLength];
+  unsigned char frameReceived[frameCodedLength];
+  unsigned char frameDecoded[frameLength];
+  unsigned char message[originalLength];
+  
+  crcFrame.encode(original, frame, originalLength);
+  hammingRepCode.encode(frame, frameCoded, frameLength);
+  Serial.println("Trama (mensaje y CRC):");
+  printBinaryVector(frame, frameLength);
+  
+  // Enviar muchas veces la misma trama y contar las que rechaza el CRC
+  const int FRAME_COUNT = 1000;
+  for (int i = 0; i < FRAME_COUNT; i++) {
+    noisyChannel(frameCoded, frameReceived, frameCodedLength, ERROR_PROBABILITY);
+    hammingRepCode.decode(frameReceived, frameDecoded, frameCodedLength);
+    crcFrame.decode(frameDecoded, message, frameLength);
+  }
+  Serial.println("Tramas enviadas: " + String(FRAME_COUNT));
+  Serial.println("Tramas correctas según el CRC: " + String(crcFrame.getPassedFrames()));
+  Serial.println("Tramas rechazadas por el CRC: " + String(crcFrame.getFailedFrames()));
 }
 
 void loop() {
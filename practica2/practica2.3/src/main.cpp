@@ -7,22 +7,122 @@
  */
 #include <Arduino.h>
 
+// Grado máximo que se decodifica por planos: cada copia ocupa un byte de una palabra de 64 bits
+const int MAX_SLICED_DEGREE = 8;
+
+// Tabla de separación en planos para el grado planeLanesDegree. Para el byte b de un grupo de
+// n bytes (8 bits decodificados) con valor v, el byte k de planeLanes[b][v] contiene los bits
+// que ese byte aporta a la copia k, con el primer bit decodificado en el bit más significativo
+uint64_t planeLanes[MAX_SLICED_DEGREE][256];
+int planeLanesDegree = 0; // Grado con el que se ha generado la tabla (0 = sin generar)
+
+/**
+ * Función auxiliar que genera la tabla de separación en planos para el grado n.
+ * @param n Grado de repetición (entre 1 y MAX_SLICED_DEGREE)
+ */
+void buildPlaneLanes(int n) {
+  for (int b = 0; b < n; b++) {
+    for (int v = 0; v < 256; v++) {
+      uint64_t lanes = 0;
+      for (int i = 0; i < 8; i++) {
+        if ((v >> (7 - i)) & 1) {
+          int groupBit = 8 * b + i;      // Posición del bit dentro del grupo
+          int decodedBit = groupBit / n; // Bit decodificado al que pertenece
+          int copy = groupBit % n;       // Copia (plano) a la que pertenece
+          lanes |= (uint64_t)1 << (8 * copy + 7 - decodedBit);
+        }
+      }
+      planeLanes[b][v] = lanes;
+    }
+  }
+  planeLanesDegree = n;
+}
+
+/**
+ * Función auxiliar que calcula la mayoría de n planos de bits con operaciones lógicas.
+ * @param planes Planos de bits, uno por copia
+ * @param n Número de planos (entre 1 y MAX_SLICED_DEGREE)
+ * @return Palabra con un 1 donde más de la mitad de los planos valen 1
+ */
+uint64_t majorityOfPlanes(const uint64_t *planes, int n) {
+  if (n == 3) {
+    return (planes[0] & planes[1]) | (planes[2] & (planes[0] ^ planes[1]));
+  }
+  
+  // Contador binario en paralelo: count[b] es el bit b del número de unos de cada posición
+  const int COUNT_BITS = 4;
+  uint64_t count[COUNT_BITS] = {0};
+  for (int k = 0; k < n; k++) {
+    uint64_t carry = planes[k];
+    for (int b = 0; b < COUNT_BITS && carry != 0; b++) {
+      uint64_t nextCarry = count[b] & carry;
+      count[b] ^= carry;
+      carry = nextCarry;
+    }
+  }
+  
+  // Comparar el contador con el umbral n / 2 + 1, del bit más significativo al menos
+  int threshold = n / 2 + 1;
+  uint64_t greater = 0;
+  uint64_t equal = ~(uint64_t)0;
+  for (int b = COUNT_BITS - 1; b >= 0; b--) {
+    if ((threshold >> b) & 1) {
+      equal &= count[b];
+    } else {
+      greater |= equal & count[b];
+      equal &= ~count[b];
+    }
+  }
+  return greater | equal;
+}
+
 /**
  * Función que implementa un decodificador de repetición.
+ * Con grado n <= MAX_SLICED_DEGREE cada bloque de 8 * n bytes (64 bits decodificados) se
+ * separa en n planos de 64 bits, uno por copia, y la mayoría se calcula con operaciones
+ * lógicas sobre los planos. El resto del mensaje, y los grados mayores, se decodifican
+ * bit a bit.
  * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
  * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
  * @param l Longitud del vector de entrada en bytes
  * @param n Grado del decodificador de repetición (número de veces que se repitió cada bit)
  */
 void repetitionDecoder(unsigned char *in, unsigned char *out, int l, int n) {
-  int inBitIndex = 0;  // Índice del bit actual en el vector de entrada
-  int outBitIndex = 0; // Índice del bit actual en el vector de salida
+  // Bloques completos de 64 bits decodificados
+  int blocks = (n <= MAX_SLICED_DEGREE) ? l / (8 * n) : 0;
+  if (blocks > 0 && planeLanesDegree != n) {
+    buildPlaneLanes(n);
+  }
+  
+  for (int block = 0; block < blocks; block++) {
+    uint64_t planes[MAX_SLICED_DEGREE] = {0};
+    
+    // Cada grupo de n bytes aporta un byte (8 bits decodificados) a cada plano
+    for (int g = 0; g < 8; g++) {
+      const unsigned char *group = in + (block * 8 + g) * n;
+      uint64_t lanes = 0;
+      for (int b = 0; b < n; b++) {
+        lanes |= planeLanes[b][group[b]];
+      }
+      for (int k = 0; k < n; k++) {
+        planes[k] |= ((lanes >> (8 * k)) & 0xFF) << (56 - 8 * g);
+      }
+    }
+    
+    uint64_t decoded = majorityOfPlanes(planes, n);
+    for (int i = 0; i < 8; i++) {
+      out[block * 8 + i] = (unsigned char)(decoded >> (56 - 8 * i));
+    }
+  }
+  
+  int inBitIndex = blocks * 64 * n; // Índice del bit actual en el vector de entrada
+  int outBitIndex = blocks * 64;    // Índice del bit actual en el vector de salida
   
-  // Inicializar el vector de salida a ceros
+  // Inicializar a ceros el resto del vector de salida
   int outLength = (l * 8) / n; // Número total de bits en el mensaje original
   int outBytes = (outLength + 7) / 8; // Número de bytes necesarios para almacenar el mensaje original
   
-  for (int i = 0; i < outBytes; i++) {
+  for (int i = blocks * 8; i < outBytes; i++) {
     out[i] = 0;
   }
   
@@ -6,63 +6,43 @@
  * Cada byte de entrada contiene dos bloques de 4 bits que deben codificarse por separado.
  */
 #include <Arduino.h>
+// Palabra código de 7 bits de cada bloque de 4 bits (p1 en el bit 6, d4 en el bit 0).
+// Se obtiene con las ecuaciones de paridad p1 = d1 + d2 + d4, p2 = d1 + d3 + d4 y
+// p3 = d2 + d3 + d4, en el orden p1, p2, d1, p3, d2, d3, d4.
+const unsigned char hammingEncodeTable[16] = {
+  0x00, 0x69, 0x2A, 0x43, 0x4C, 0x25, 0x66, 0x0F, 0x70, 0x19, 0x5A, 0x33, 0x3C, 0x55, 0x16, 0x7F
+};
+
 /*
  * Función que implementa un codificador de bloque Hamming (7,4).
+ * Cada bloque de 4 bits se codifica con una consulta a la tabla y las palabras de 7 bits se
+ * acumulan en una variable de 64 bits, de la que se escriben los bytes completos.
  * @param in Vector binario de entrada empaquetado en unsigned char
  * @param out Vector binario de salida empaquetado en unsigned char
  * @param l Longitud del vector de entrada en bytes
  */
 void hammingCoder(unsigned char *in, unsigned char *out, int l) {
-  int outBitIndex = 0; // Índice del bit actual en el vector de salida
+  uint64_t buffer = 0;  // Bits pendientes de escribir, alineados a la derecha
+  int bufferBits = 0;   // Número de bits pendientes
+  int outByteIndex = 0; // Índice del byte actual en el vector de salida
   
   // Recorrer cada byte del vector de entrada
   for (int i = 0; i < l; i++) {
-    // Procesar cada bloque de 4 bits del byte actual (primero los 4 bits más significativos)
-    for (int nibbleIndex = 0; nibbleIndex < 2; nibbleIndex++) {
-      // Extraer el bloque de 4 bits
-      unsigned char nibble;
-      if (nibbleIndex == 0) {
-        // Extraer los 4 bits más significativos (posiciones 7-4)
-        nibble = (in[i] >> 4) & 0x0F;
-      } else {
-        // Extraer los 4 bits menos significativos (posiciones 3-0)
-        nibble = in[i] & 0x0F;
-      }
-      
-      // Extraer los bits de datos individuales (d1, d2, d3, d4)
-      unsigned char d1 = (nibble >> 3) & 1; // Bit más significativo
-      unsigned char d2 = (nibble >> 2) & 1;
-      unsigned char d3 = (nibble >> 1) & 1;
-      unsigned char d4 = nibble & 1;        // Bit menos significativo
-      
-      // Calcular los bits de paridad según las ecuaciones de Hamming (7,4)
-      unsigned char p1 = d1 ^ d2 ^ d4;      // p1 = d1 + d2 + d4 (XOR)
-      unsigned char p2 = d1 ^ d3 ^ d4;      // p2 = d1 + d3 + d4 (XOR)
-      unsigned char p3 = d2 ^ d3 ^ d4;      // p3 = d2 + d3 + d4 (XOR)
-      
-      // Formar la palabra código de 7 bits: p1, p2, d1, p3, d2, d3, d4
-      unsigned char resultado[7] = {p1, p2, d1, p3, d2, d3, d4};
-      
-      // Colocar los 7 bits de la palabra código en el vector de salida
-      for (int j = 0; j < 7; j++) {
-        // Calcular el índice del byte de salida donde se colocará el bit
-        int outByteIndex = outBitIndex / 8;
-        // Calcular la posición del bit dentro del byte de salida
-        int outBitPosition = 7 - (outBitIndex % 8);
-        
-        // Si estamos en un nuevo byte, inicializarlo a 0
-        if (outBitPosition == 7) {
-          out[outByteIndex] = 0;
-        }
-        
-        // Colocar el bit en la posición correspondiente del byte de salida
-        out[outByteIndex] |= (resultado[j] << outBitPosition);
-        
-        // Incrementar el índice del bit de salida
-        outBitIndex++;
-      }
+    // Los dos bloques de 4 bits del byte (primero el más significativo) dan 14 bits
+    buffer = (buffer << 14) | (hammingEncodeTable[in[i] >> 4] << 7) | hammingEncodeTable[in[i] & 0x0F];
+    bufferBits += 14;
+    
+    // Escribir los bytes completos
+    while (bufferBits >= 8) {
+      bufferBits -= 8;
+      out[outByteIndex++] = (unsigned char)(buffer >> bufferBits);
     }
   }
+  
+  // Último byte incompleto, completado con ceros
+  if (bufferBits > 0) {
+    out[outByteIndex] = (unsigned char)(buffer << (8 - bufferBits));
+  }
 }
 
 // Función para imprimir un vector de bytes en formato binario
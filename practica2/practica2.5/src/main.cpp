@@ -6,97 +6,56 @@
  */
 #include <Arduino.h>
 
+// Bloque de 4 bits corregido de cada palabra de 7 bits recibida (p1 en el bit 6, d4 en el
+// bit 0). Para cada palabra se calcula el síndrome (s1 = p1 + d1 + d2 + d4,
+// s2 = p2 + d1 + d3 + d4, s3 = p3 + d2 + d3 + d4), se invierte el bit que indica y se
+// extraen d1, d2, d3 y d4.
+const unsigned char hammingDecodeTable[128] = {
+  0x0, 0x0, 0x0, 0x3, 0x0, 0x5, 0xE, 0x7, 0x0, 0x9, 0x2, 0x7, 0x4, 0x7, 0x7, 0x7,
+  0x0, 0x9, 0xE, 0xB, 0xE, 0xD, 0xE, 0xE, 0x9, 0x9, 0xA, 0x9, 0xC, 0x9, 0xE, 0x7,
+  0x0, 0x5, 0x2, 0xB, 0x5, 0x5, 0x6, 0x5, 0x2, 0x1, 0x2, 0x2, 0xC, 0x5, 0x2, 0x7,
+  0x8, 0xB, 0xB, 0xB, 0xC, 0x5, 0xE, 0xB, 0xC, 0x9, 0x2, 0xB, 0xC, 0xC, 0xC, 0xF,
+  0x0, 0x3, 0x3, 0x3, 0x4, 0xD, 0x6, 0x3, 0x4, 0x1, 0xA, 0x3, 0x4, 0x4, 0x4, 0x7,
+  0x8, 0xD, 0xA, 0x3, 0xD, 0xD, 0xE, 0xD, 0xA, 0x9, 0xA, 0xA, 0x4, 0xD, 0xA, 0xF,
+  0x8, 0x1, 0x6, 0x3, 0x6, 0x5, 0x6, 0x6, 0x1, 0x1, 0x2, 0x1, 0x4, 0x1, 0x6, 0xF,
+  0x8, 0x8, 0x8, 0xB, 0x8, 0xD, 0x6, 0xF, 0x8, 0x1, 0xA, 0xF, 0xC, 0xF, 0xF, 0xF
+};
+
 /**
  * Función que implementa un decodificador de bloque Hamming (7,4).
+ * Las palabras de 7 bits se leen de una variable de 64 bits que se va llenando byte a byte
+ * y cada una se corrige y decodifica con una consulta a la tabla.
  * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
  * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
  * @param l Longitud del vector de entrada en bytes
  * @param n Grado del decodificador de repetición (no se utiliza en este caso, pero se mantiene por compatibilidad)
  */
 void hammingDecoder(unsigned char *in, unsigned char *out, int l, int n) {
-  int inBitIndex = 0;   // Índice del bit actual en el vector de entrada
-  int outBitIndex = 0;  // Índice del bit actual en el vector de salida
-  
-  // Inicializar el vector de salida a ceros
-  int outBytes = (l * 8 * 4) / 7; // Aproximación del número de bytes necesarios
-  outBytes = (outBytes + 7) / 8;  // Redondeo hacia arriba
+  uint64_t buffer = 0;  // Bits pendientes de leer, alineados a la derecha
+  int bufferBits = 0;   // Número de bits pendientes
+  int inByteIndex = 0;  // Índice del byte actual en el vector de entrada
   
-  for (int i = 0; i < outBytes; i++) {
-    out[i] = 0;
-  }
+  // Número de palabras código completas de 7 bits
+  int codewords = (l * 8) / 7;
   
   // Procesar cada palabra código de 7 bits
-  while (inBitIndex + 6 < l * 8) { // Asegurarse de que hay al menos 7 bits disponibles
-    // Extraer los 7 bits de la palabra código
-    unsigned char codeword[7];
-    
-    for (int j = 0; j < 7; j++) {
-      // Calcular el índice del byte de entrada y la posición del bit
-      int inByteIndex = inBitIndex / 8;
-      int inBitPosition = 7 - (inBitIndex % 8);
-      
-      // Extraer el bit de la posición correspondiente
-      codeword[j] = (in[inByteIndex] >> inBitPosition) & 1;
-      
-      // Avanzar al siguiente bit de entrada
-      inBitIndex++;
+  for (int c = 0; c < codewords; c++) {
+    // Cargar un byte más si no quedan 7 bits pendientes
+    if (bufferBits < 7) {
+      buffer = (buffer << 8) | in[inByteIndex++];
+      bufferBits += 8;
     }
+    bufferBits -= 7;
     
-    // Extraer bits de paridad y datos de la palabra código
-    unsigned char p1 = codeword[0]; // Bit de paridad 1
-    unsigned char p2 = codeword[1]; // Bit de paridad 2
-    unsigned char d1 = codeword[2]; // Bit de dato 1
-    unsigned char p3 = codeword[3]; // Bit de paridad 3
-    unsigned char d2 = codeword[4]; // Bit de dato 2
-    unsigned char d3 = codeword[5]; // Bit de dato 3
-    unsigned char d4 = codeword[6]; // Bit de dato 4
-    
-    // Calcular el síndrome para detectar errores
-    unsigned char s1 = p1 ^ d1 ^ d2 ^ d4; // Verificar paridad 1
-    unsigned char s2 = p2 ^ d1 ^ d3 ^ d4; // Verificar paridad 2
-    unsigned char s3 = p3 ^ d2 ^ d3 ^ d4; // Verificar paridad 3
-    
-    // Determinar la posición del error (si existe)
-    unsigned char errorPos = (s3 << 2) | (s2 << 1) | s1;
+    // Corregir y decodificar la palabra con la tabla
+    unsigned char nibble = hammingDecodeTable[(buffer >> bufferBits) & 0x7F];
     
-    // Corregir el error si se detecta (errorPos != 0)
-    if (errorPos != 0) {
-      // Posiciones de error y su correspondencia en el array codeword
-      // 1 -> p1 (índice 0)
-      // 2 -> p2 (índice 1)
-      // 3 -> d1 (índice 2)
-      // 4 -> p3 (índice 3)
-      // 5 -> d2 (índice 4)
-      // 6 -> d3 (índice 5)
-      // 7 -> d4 (índice 6)
-      
-      // Corregir el bit erróneo
-      if (errorPos >= 1 && errorPos <= 7) {
-        // Invertir el bit en la posición del error
-        codeword[errorPos - 1] = codeword[errorPos - 1] ^ 1;
-        
-        // Actualizar los bits de datos si fueron corregidos
-        if (errorPos == 3) d1 = codeword[2];
-        else if (errorPos == 5) d2 = codeword[4];
-        else if (errorPos == 6) d3 = codeword[5];
-        else if (errorPos == 7) d4 = codeword[6];
-      }
-    }
-    
-    // Reconstruir el nibble (4 bits) original
-    unsigned char nibble = (d1 << 3) | (d2 << 2) | (d3 << 1) | d4;
-    
-    // Determinar si este nibble va en la parte alta o baja del byte de salida
-    if (outBitIndex % 8 == 0) {
-      // Parte alta del byte (bits 7-4)
-      out[outBitIndex / 8] |= (nibble << 4);
+    // Las palabras pares van a la parte alta del byte (bits 7-4) y las impares a la baja (bits 3-0)
+    if (c % 2 == 0) {
+      out[c / 2] = nibble << 4;
     } else {
-      // Parte baja del byte (bits 3-0)
-      out[outBitIndex / 8] |= nibble;
+      out[c / 2] |= nibble;
     }
-    
-    // Avanzar 4 bits en el índice de salida (un nibble)
-    outBitIndex += 4;
   }
 }
 
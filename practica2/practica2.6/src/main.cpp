@@ -6,38 +6,216 @@
  */
 
 #include <Arduino.h>
+#include <math.h>
+#include <string.h>
 
 /**
- * Clase que simula un canal ruidoso para comunicaciones binarias.
- * Permite configurar el porcentaje de ruido que se introducirá en los mensajes.
+ * Generador pseudoaleatorio xoshiro256** de 64 bits.
+ * Es rápido, reproducible a partir de una semilla explícita y permite saltar 2^128
+ * valores hacia delante, de modo que cada trabajador de una simulación puede usar
+ * una subsecuencia propia que no se solapa con las de los demás.
  */
-class NoisyChannel {
+class Xoshiro256 {
 private:
-  float noisePercentage; // Porcentaje de ruido (entre 0 y 1)
+  uint64_t state[4]; // Estado interno del generador
+  
+  // Rotación a la izquierda de 64 bits
+  static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
   
-  // Inicializa la semilla para la generación de números aleatorios
-  void initRandomSeed() {
-    randomSeed(analogRead(0));
+  // Paso del generador SplitMix64, usado para expandir la semilla al estado completo
+  static uint64_t splitMix64(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  
+  // Avanza el estado según el polinomio de salto indicado
+  void applyJump(const uint64_t *polynomial) {
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+      for (int b = 0; b < 64; b++) {
+        if (polynomial[i] & ((uint64_t)1 << b)) {
+          s0 ^= state[0];
+          s1 ^= state[1];
+          s2 ^= state[2];
+          s3 ^= state[3];
+        }
+        next();
+      }
+    }
+    state[0] = s0;
+    state[1] = s1;
+    state[2] = s2;
+    state[3] = s3;
   }
   
 public:
   /**
-   * Constructor de la clase NoisyChannel.
-   * @param noise Porcentaje de ruido que se introducirá en los mensajes (entre 0 y 1)
+   * Constructor de la clase
+   * @param seed Semilla de 64 bits
    */
-  NoisyChannel(float noise) {
-    // Asegurar que el porcentaje de ruido esté entre 0 y 1
-    noisePercentage = constrain(noise, 0.0, 1.0);
-    initRandomSeed();
+  Xoshiro256(uint64_t seed = 0) {
+    setSeed(seed);
   }
   
   /**
-   * Envía un paquete a través del canal ruidoso.
-   * @param input Vector binario de entrada empaquetado en unsigned char
-   * @param output Vector binario de salida empaquetado en unsigned char
-   * @param length Longitud del vector en bytes
+   * Reinicia el generador a partir de una semilla de 64 bits
+   * @param seed Semilla
+   */
+  void setSeed(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+      state[i] = splitMix64(seed);
+    }
+  }
+  
+  /**
+   * Genera el siguiente valor de 64 bits
+   * @return Valor aleatorio de 64 bits
+   */
+  uint64_t next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+    
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    
+    return result;
+  }
+  
+  /**
+   * Genera el siguiente valor de 32 bits (los 32 bits altos, que son los de mejor calidad)
+   * @return Valor aleatorio de 32 bits
+   */
+  uint32_t next32() {
+    return (uint32_t)(next() >> 32);
+  }
+  
+  /**
+   * Avanza el generador 2^128 valores. Llamándolo k veces sobre la misma semilla
+   * se obtiene la k-ésima subsecuencia independiente.
    */
-  void sendPacket(unsigned char *input, unsigned char *output, int length) {
+  void jump() {
+    static const uint64_t JUMP[4] = {
+      0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    applyJump(JUMP);
+  }
+  
+  /**
+   * Avanza el generador 2^192 valores, para repartir subsecuencias entre grupos de trabajadores.
+   */
+  void longJump() {
+    static const uint64_t LONG_JUMP[4] = {
+      0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL
+    };
+    applyJump(LONG_JUMP);
+  }
+};
+
+/**
+ * Clase que simula un canal ruidoso para comunicaciones binarias.
+ * Permite configurar el porcentaje de ruido que se introducirá en los mensajes.
+ *
+ * Dispone de dos modos de funcionamiento:
+ * - MODE_BIT: genera un número aleatorio por cada bit y lo compara con f a resolución completa.
+ * - MODE_WORD: construye máscaras de error de 64 bits de una vez y las aplica con XOR
+ *   palabra a palabra. Para f bajas se usa muestreo geométrico de huecos (se salta
+ *   directamente al siguiente bit erróneo) y para f altas se construye la máscara
+ *   bit a bit como combinación AND/OR de palabras aleatorias (Bernoulli por palabra).
+ *
+ * Los números aleatorios salen de un generador xoshiro256** propio del canal, con semilla
+ * explícita de 64 bits y selección de subsecuencia, para poder repetir exactamente una
+ * simulación y repartirla entre varios trabajadores sin solapamiento.
+ */
+class NoisyChannel {
+public:
+  // Modos de generación de errores
+  enum Mode {
+    MODE_BIT,  // Un número aleatorio por bit
+    MODE_WORD  // Máscaras de error de 64 bits
+  };
+  
+private:
+  // Por debajo de esta probabilidad compensa el muestreo geométrico de huecos
+  static constexpr float GAP_SAMPLING_MAX_NOISE = 0.1;
+  // Bits de precisión con los que se representa f en el modo Bernoulli por palabra
+  static const int BERNOULLI_PRECISION = 24;
+  
+  float noisePercentage; // Porcentaje de ruido (entre 0 y 1)
+  Mode mode;             // Modo de generación de errores
+  
+  Xoshiro256 generator;  // Generador pseudoaleatorio del canal
+  uint64_t seed;         // Semilla con la que se inicializó el generador
+  uint64_t bitThreshold; // f escalada a 2^32, para comparar en el modo MODE_BIT
+  
+  // Estado del generador de máscaras (modo MODE_WORD)
+  bool useGapSampling;         // true si se usa muestreo geométrico de huecos
+  float inverseLogNoNoise;     // 1 / ln(1 - f), para muestrear la longitud de los huecos
+  uint32_t bitsToNextError;    // Bits correctos que faltan hasta el siguiente error
+  uint32_t bernoulliThreshold; // f cuantizada con BERNOULLI_PRECISION bits
+  int bernoulliFirstRound;     // Primer bit no nulo de bernoulliThreshold
+  
+  // Obtiene una semilla de la fuente de entropía del hardware (solo al construir el canal)
+  static uint64_t hardwareSeed() {
+#if defined(ESP32)
+    return ((uint64_t)esp_random() << 32) | esp_random();
+#else
+    return ((uint64_t)analogRead(0) << 32) ^ micros();
+#endif
+  }
+  
+  // Devuelve 32 bits aleatorios
+  uint32_t nextRandom32() {
+    return generator.next32();
+  }
+  
+  // Devuelve 64 bits aleatorios
+  uint64_t nextRandom64() {
+    return generator.next();
+  }
+  
+  // Muestrea el número de bits correctos antes del siguiente error (distribución geométrica)
+  uint32_t sampleGap() {
+    // u en (0, 1], nunca 0 para que el logaritmo esté definido
+    float u = (nextRandom32() + 1.0f) * (1.0f / 4294967296.0f);
+    float gap = logf(u) * inverseLogNoNoise;
+    if (gap >= 4294967295.0f) {
+      return 0xFFFFFFFF;
+    }
+    return (uint32_t)gap;
+  }
+  
+  // Recalcula los parámetros del generador de máscaras a partir de noisePercentage
+  void updateMaskParameters() {
+    bitThreshold = (uint64_t)((double)noisePercentage * 4294967296.0);
+    
+    useGapSampling = noisePercentage > 0 && noisePercentage < GAP_SAMPLING_MAX_NOISE;
+    if (useGapSampling) {
+      inverseLogNoNoise = 1.0f / logf(1.0f - noisePercentage);
+      bitsToNextError = sampleGap();
+    }
+    
+    bernoulliThreshold = (uint32_t)(noisePercentage * (1 << BERNOULLI_PRECISION) + 0.5f);
+    bernoulliFirstRound = 0;
+    if (bernoulliThreshold != 0) {
+      // Los bits nulos menos significativos no aportan nada (0 AND r = 0)
+      while (((bernoulliThreshold >> bernoulliFirstRound) & 1) == 0) {
+        bernoulliFirstRound++;
+      }
+    }
+  }
+  
+  // Envío bit a bit (un número aleatorio por bit)
+  int sendPacketBitwise(unsigned char *input, unsigned char *output, int length) {
+    int flippedBits = 0;
+    
     // Recorrer cada byte del vector de entrada
     for (int i = 0; i < length; i++) {
       // Inicializar el byte de salida con el valor del byte de entrada
@@ -45,17 +223,85 @@ public:
       
       // Procesar cada bit del byte actual
       for (int j = 0; j < 8; j++) {
-        // Generar un número aleatorio entre 0 y 1
-        float r = random(0, 100) / 100.0;
-        
-        // Si el número aleatorio es menor que la probabilidad de error,
+        // Si el número aleatorio de 32 bits es menor que f * 2^32,
         // invertir el bit correspondiente en el byte de salida
-        if (r < noisePercentage) {
+        if (nextRandom32() < bitThreshold) {
           // Invertir el bit j-ésimo usando XOR con una máscara
           output[i] ^= (1 << j);
+          flippedBits++;
         }
       }
     }
+    return flippedBits;
+  }
+  
+  // Envío palabra a palabra con máscaras de error de 64 bits
+  int sendPacketWordwise(unsigned char *input, unsigned char *output, int length) {
+    int flippedBits = 0;
+    int i = 0;
+    
+    // Aplicar una máscara por cada bloque completo de 8 bytes
+    for (; i + 8 <= length; i += 8) {
+      uint64_t word;
+      uint64_t mask = nextErrorMask();
+      memcpy(&word, input + i, 8);
+      word ^= mask;
+      memcpy(output + i, &word, 8);
+      flippedBits += __builtin_popcountll(mask);
+    }
+    
+    // Bytes restantes: se usan los bytes bajos de una última máscara
+    if (i < length) {
+      uint64_t mask = nextErrorMask();
+      for (; i < length; i++) {
+        unsigned char byteMask = mask & 0xFF;
+        output[i] = input[i] ^ byteMask;
+        flippedBits += __builtin_popcount(byteMask);
+        mask >>= 8;
+      }
+    }
+    return flippedBits;
+  }
+  
+public:
+  /**
+   * Constructor de la clase NoisyChannel.
+   * La semilla se toma de la fuente de entropía del hardware.
+   * @param noise Porcentaje de ruido que se introducirá en los mensajes (entre 0 y 1)
+   * @param channelMode Modo de generación de errores (por defecto, máscaras por palabra)
+   */
+  NoisyChannel(float noise, Mode channelMode = MODE_WORD) {
+    // Asegurar que el porcentaje de ruido esté entre 0 y 1
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    mode = channelMode;
+    setSeed(hardwareSeed());
+  }
+  
+  /**
+   * Constructor de la clase NoisyChannel con semilla explícita (simulaciones reproducibles).
+   * @param noise Porcentaje de ruido que se introducirá en los mensajes (entre 0 y 1)
+   * @param channelSeed Semilla de 64 bits del generador
+   * @param channelMode Modo de generación de errores (por defecto, máscaras por palabra)
+   */
+  NoisyChannel(float noise, uint64_t channelSeed, Mode channelMode = MODE_WORD) {
+    noisePercentage = constrain(noise, 0.0, 1.0);
+    mode = channelMode;
+    setSeed(channelSeed);
+  }
+  
+  /**
+   * Envía un paquete a través del canal ruidoso.
+   * La entrada y la salida pueden ser el mismo vector.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
+   */
+  int sendPacket(unsigned char *input, unsigned char *output, int length) {
+    if (mode == MODE_BIT) {
+      return sendPacketBitwise(input, output, length);
+    }
+    return sendPacketWordwise(input, output, length);
   }
   
   /**
@@ -64,10 +310,49 @@ public:
    * @param input Vector binario de entrada empaquetado en unsigned char
    * @param output Vector binario de salida empaquetado en unsigned char
    * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
    */
-  void receivePacket(unsigned char *input, unsigned char *output, int length) {
+  int receivePacket(unsigned char *input, unsigned char *output, int length) {
     // En un canal simétrico, enviar y recibir son operaciones equivalentes
-    sendPacket(input, output, length);
+    return sendPacket(input, output, length);
+  }
+  
+  /**
+   * Genera una máscara de error de 64 bits donde cada bit vale 1 con probabilidad f.
+   * Es la base del modo MODE_WORD y la usan también otros canales para construir sus errores.
+   * @return Máscara de error
+   */
+  uint64_t nextErrorMask() {
+    if (useGapSampling) {
+      // Saltar directamente de un error al siguiente
+      uint64_t mask = 0;
+      while (bitsToNextError < 64) {
+        mask |= (uint64_t)1 << bitsToNextError;
+        uint32_t gap = sampleGap();
+        bitsToNextError = (gap > 0xFFFFFFFF - 65) ? 0xFFFFFFFF : bitsToNextError + 1 + gap;
+      }
+      bitsToNextError -= 64;
+      return mask;
+    }
+    
+    if (bernoulliThreshold == 0) {
+      return 0;
+    }
+    if (bernoulliThreshold >= (1u << BERNOULLI_PRECISION)) {
+      return ~(uint64_t)0;
+    }
+    
+    // Comparar cada bit con la expansión binaria de f, del bit menos significativo al más
+    // significativo: un 1 en f combina con OR y un 0 combina con AND
+    uint64_t mask = 0;
+    for (int k = bernoulliFirstRound; k < BERNOULLI_PRECISION; k++) {
+      if ((bernoulliThreshold >> k) & 1) {
+        mask |= nextRandom64();
+      } else {
+        mask &= nextRandom64();
+      }
+    }
+    return mask;
   }
   
   /**
@@ -84,6 +369,603 @@ public:
    */
   void setNoisePercentage(float noise) {
     noisePercentage = constrain(noise, 0.0, 1.0);
+    updateMaskParameters();
+  }
+  
+  /**
+   * Obtiene el modo de generación de errores.
+   * @return Modo actual
+   */
+  Mode getMode() {
+    return mode;
+  }
+  
+  /**
+   * Establece el modo de generación de errores.
+   * @param channelMode Nuevo modo
+   */
+  void setMode(Mode channelMode) {
+    mode = channelMode;
+  }
+  
+  /**
+   * Reinicia el generador del canal con una semilla explícita.
+   * Dos canales con la misma semilla y configuración producen exactamente los mismos errores.
+   * @param channelSeed Semilla de 64 bits
+   */
+  void setSeed(uint64_t channelSeed) {
+    seed = channelSeed;
+    generator.setSeed(seed);
+    updateMaskParameters();
+  }
+  
+  /**
+   * Obtiene la semilla con la que se inicializó el generador.
+   * @return Semilla de 64 bits
+   */
+  uint64_t getSeed() {
+    return seed;
+  }
+  
+  /**
+   * Selecciona la subsecuencia aleatoria número streamIndex de la semilla actual.
+   * Cada subsecuencia está separada 2^128 valores de la siguiente, así que trabajadores
+   * con la misma semilla e índices distintos nunca comparten números aleatorios.
+   * @param streamIndex Índice de la subsecuencia (0 es la secuencia original)
+   */
+  void selectStream(int streamIndex) {
+    generator.setSeed(seed);
+    for (int i = 0; i < streamIndex; i++) {
+      generator.jump();
+    }
+    updateMaskParameters();
+  }
+};
+
+/**
+ * Clase que simula un canal con ráfagas de errores según el modelo de Gilbert-Elliott.
+ * El canal alterna entre un estado bueno (G) y un estado malo (B), cada uno con su propia
+ * probabilidad de error de bit. En lugar de decidir la transición de estado bit a bit,
+ * se muestrea directamente la duración de cada estancia (distribución geométrica) y se
+ * aplican máscaras de error de 64 bits sobre cada tramo, por lo que simular ráfagas
+ * cuesta prácticamente lo mismo que el canal sin memoria.
+ *
+ * Cada estancia en el estado malo se considera una ráfaga y su longitud en bits se
+ * acumula en un histograma logarítmico (la clase k cuenta ráfagas de 2^k a 2^(k+1)-1 bits),
+ * útil para dimensionar la profundidad de un entrelazador.
+ */
+class GilbertElliottChannel {
+public:
+  static const int BURST_HISTOGRAM_BINS = 32; // Número de clases del histograma de ráfagas
+  
+private:
+  float goodToBad;            // Probabilidad de pasar de G a B en cada bit
+  float badToGood;            // Probabilidad de pasar de B a G en cada bit
+  NoisyChannel goodChannel;   // Generador de máscaras de error del estado G
+  NoisyChannel badChannel;    // Generador de máscaras de error del estado B
+  Xoshiro256 dwellGenerator;  // Generador para las duraciones de cada estado
+  uint64_t seed;              // Semilla del canal
+  
+  bool inBadState;            // Estado actual del canal
+  uint32_t bitsLeftInState;   // Bits que quedan hasta el siguiente cambio de estado
+  
+  // Estadísticas de ráfagas
+  unsigned long burstHistogram[BURST_HISTOGRAM_BINS];
+  unsigned long burstCount;
+  uint32_t longestBurst;
+  uint64_t totalBurstBits;
+  
+  // Muestrea cuántos bits permanece el canal en un estado con probabilidad de salida p
+  uint32_t sampleDwell(float p) {
+    if (p <= 0) {
+      return 0xFFFFFFFF;
+    }
+    if (p >= 1) {
+      return 1;
+    }
+    float u = (dwellGenerator.next32() + 1.0f) * (1.0f / 4294967296.0f);
+    float dwell = 1.0f + logf(u) / logf(1.0f - p);
+    if (dwell >= 4294967295.0f) {
+      return 0xFFFFFFFF;
+    }
+    return (uint32_t)dwell;
+  }
+  
+  // Cambia de estado y muestrea la duración de la nueva estancia
+  void changeState() {
+    inBadState = !inBadState;
+    if (inBadState) {
+      bitsLeftInState = sampleDwell(badToGood);
+      recordBurst(bitsLeftInState);
+    } else {
+      bitsLeftInState = sampleDwell(goodToBad);
+    }
+  }
+  
+  // Añade una ráfaga de la longitud indicada a las estadísticas
+  void recordBurst(uint32_t length) {
+    int bin = 31 - __builtin_clz(length);
+    burstHistogram[bin]++;
+    burstCount++;
+    totalBurstBits += length;
+    if (length > longestBurst) {
+      longestBurst = length;
+    }
+  }
+  
+  // Aplica con XOR una máscara de 64 bits sobre la palabra wordIndex del vector.
+  // El bit 63 de la máscara corresponde al bit más significativo del primer byte de la palabra.
+  static void xorWord(unsigned char *buffer, int length, long wordIndex, uint64_t mask) {
+    long first = wordIndex * 8;
+    for (int k = 0; k < 8 && first + k < length; k++) {
+      buffer[first + k] ^= (unsigned char)(mask >> (56 - 8 * k));
+    }
+  }
+  
+  // Aplica los errores del estado indicado a los bits [start, end) del vector
+  int applyRun(NoisyChannel &state, unsigned char *buffer, int length, long start, long end) {
+    int flippedBits = 0;
+    long pos = start;
+    while (pos < end) {
+      long wordIndex = pos / 64;
+      long wordStart = wordIndex * 64;
+      int from = pos - wordStart;
+      int to = (end - wordStart < 64) ? (int)(end - wordStart) : 64;
+      
+      // Bits [from, to) de la palabra, contando desde el más significativo
+      uint64_t range = ~(uint64_t)0 >> from;
+      if (to < 64) {
+        range &= ~(~(uint64_t)0 >> to);
+      }
+      
+      uint64_t mask = state.nextErrorMask() & range;
+      if (mask != 0) {
+        xorWord(buffer, length, wordIndex, mask);
+        flippedBits += __builtin_popcountll(mask);
+      }
+      pos = wordStart + to;
+    }
+    return flippedBits;
+  }
+  
+public:
+  /**
+   * Constructor de la clase GilbertElliottChannel.
+   * @param pGoodToBad Probabilidad de pasar del estado bueno al malo en cada bit
+   * @param pBadToGood Probabilidad de pasar del estado malo al bueno en cada bit
+   * @param errorGood Probabilidad de error de bit en el estado bueno
+   * @param errorBad Probabilidad de error de bit en el estado malo
+   * @param channelSeed Semilla de 64 bits del canal
+   */
+  GilbertElliottChannel(float pGoodToBad, float pBadToGood, float errorGood, float errorBad, uint64_t channelSeed)
+    : goodChannel(errorGood, channelSeed), badChannel(errorBad, channelSeed) {
+    goodToBad = constrain(pGoodToBad, 0.0, 1.0);
+    badToGood = constrain(pBadToGood, 0.0, 1.0);
+    setSeed(channelSeed);
+  }
+  
+  /**
+   * Envía un paquete a través del canal con ráfagas.
+   * El estado del canal se conserva entre paquetes, así que una ráfaga puede continuar
+   * en el paquete siguiente. La entrada y la salida pueden ser el mismo vector.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
+   */
+  int sendPacket(unsigned char *input, unsigned char *output, int length) {
+    if (output != input) {
+      memcpy(output, input, length);
+    }
+    
+    int flippedBits = 0;
+    long totalBits = (long)length * 8;
+    long pos = 0;
+    
+    // Recorrer el paquete tramo a tramo, un tramo por estancia en cada estado
+    while (pos < totalBits) {
+      if (bitsLeftInState == 0) {
+        changeState();
+      }
+      
+      long runEnd = pos + bitsLeftInState;
+      if (runEnd > totalBits) {
+        runEnd = totalBits;
+      }
+      bitsLeftInState -= runEnd - pos;
+      
+      NoisyChannel &state = inBadState ? badChannel : goodChannel;
+      if (state.getNoisePercentage() > 0) {
+        flippedBits += applyRun(state, output, length, pos, runEnd);
+      }
+      pos = runEnd;
+    }
+    return flippedBits;
+  }
+  
+  /**
+   * Recibe un paquete a través del canal con ráfagas (equivalente a sendPacket).
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
+   */
+  int receivePacket(unsigned char *input, unsigned char *output, int length) {
+    return sendPacket(input, output, length);
+  }
+  
+  /**
+   * Reinicia el canal (estado, generadores y estadísticas) con una semilla explícita.
+   * @param channelSeed Semilla de 64 bits
+   */
+  void setSeed(uint64_t channelSeed) {
+    seed = channelSeed;
+    selectStream(0);
+  }
+  
+  /**
+   * Selecciona la subsecuencia aleatoria número streamIndex de la semilla actual y
+   * reinicia el canal. Cada subsecuencia usa tres flujos independientes del generador
+   * (duraciones, errores en G y errores en B).
+   * @param streamIndex Índice de la subsecuencia
+   */
+  void selectStream(int streamIndex) {
+    dwellGenerator.setSeed(seed);
+    for (int i = 0; i < 3 * streamIndex; i++) {
+      dwellGenerator.jump();
+    }
+    goodChannel.setSeed(seed);
+    goodChannel.selectStream(3 * streamIndex + 1);
+    badChannel.setSeed(seed);
+    badChannel.selectStream(3 * streamIndex + 2);
+    
+    // El canal empieza en el estado bueno
+    inBadState = false;
+    bitsLeftInState = sampleDwell(goodToBad);
+    resetStatistics();
+  }
+  
+  /**
+   * Probabilidad media de error de bit en régimen estacionario.
+   * @return Probabilidad de error media
+   */
+  float getAverageErrorRate() {
+    if (goodToBad + badToGood == 0) {
+      return goodChannel.getNoisePercentage();
+    }
+    float badFraction = goodToBad / (goodToBad + badToGood);
+    return (1 - badFraction) * goodChannel.getNoisePercentage() + badFraction * badChannel.getNoisePercentage();
+  }
+  
+  /**
+   * Obtiene el número de ráfagas en la clase bin del histograma
+   * (ráfagas de entre 2^bin y 2^(bin+1)-1 bits).
+   * @param bin Clase del histograma (0 a BURST_HISTOGRAM_BINS - 1)
+   * @return Número de ráfagas en esa clase
+   */
+  unsigned long getBurstHistogram(int bin) {
+    if (bin < 0 || bin >= BURST_HISTOGRAM_BINS) {
+      return 0;
+    }
+    return burstHistogram[bin];
+  }
+  
+  /**
+   * Obtiene el número total de ráfagas (estancias en el estado malo) observadas.
+   * @return Número de ráfagas
+   */
+  unsigned long getBurstCount() {
+    return burstCount;
+  }
+  
+  /**
+   * Obtiene la longitud de la ráfaga más larga observada.
+   * @return Longitud en bits
+   */
+  uint32_t getLongestBurst() {
+    return longestBurst;
+  }
+  
+  /**
+   * Obtiene la longitud media de las ráfagas observadas.
+   * @return Longitud media en bits
+   */
+  float getAverageBurstLength() {
+    if (burstCount == 0) {
+      return 0;
+    }
+    return (float)totalBurstBits / burstCount;
+  }
+  
+  /**
+   * Pone a cero el histograma y las estadísticas de ráfagas.
+   */
+  void resetStatistics() {
+    for (int i = 0; i < BURST_HISTOGRAM_BINS; i++) {
+      burstHistogram[i] = 0;
+    }
+    burstCount = 0;
+    longestBurst = 0;
+    totalBurstBits = 0;
+  }
+};
+
+/**
+ * Clase que simula un canal BPSK con ruido blanco gaussiano aditivo (AWGN) y salida blanda.
+ * Cada bit se transmite como +1 (bit 0) o -1 (bit 1), se le suma ruido gaussiano y en lugar
+ * de decidir el bit se entrega su razón de verosimilitud logarítmica (LLR) cuantizada a int8:
+ * positiva si es más probable un 0, negativa si es más probable un 1, y con un valor absoluto
+ * que mide la fiabilidad. Los LLR se escriben en un vector contiguo, uno por bit y en el
+ * mismo orden en que se transmiten (del bit más significativo al menos significativo).
+ *
+ * Las muestras gaussianas se generan por bloques con Box-Muller, en bucles sin
+ * dependencias entre iteraciones que el compilador puede vectorizar.
+ */
+class AwgnChannel {
+public:
+  static const int LLR_MAX = 127; // Valor absoluto máximo de un LLR cuantizado
+  
+private:
+  static const int GAUSSIAN_BLOCK = 64; // Muestras gaussianas por bloque (8 bytes transmitidos)
+  
+  float snrDb;         // Relación señal/ruido por símbolo Es/N0 en dB
+  float sigma;         // Desviación típica del ruido
+  float llrScale;      // Unidades del LLR cuantizado por cada unidad de LLR real
+  float llrGain;       // Factor que convierte la muestra recibida en LLR cuantizado
+  Xoshiro256 generator; // Generador pseudoaleatorio del canal
+  uint64_t seed;       // Semilla del generador
+  
+  // Recalcula sigma y la ganancia de LLR a partir de la SNR y la escala
+  void updateParameters() {
+    float snrLinear = powf(10.0f, snrDb / 10.0f);
+    sigma = sqrtf(1.0f / (2.0f * snrLinear));
+    // LLR = 2y / sigma^2
+    llrGain = llrScale * 2.0f / (sigma * sigma);
+  }
+  
+  // Genera GAUSSIAN_BLOCK muestras gaussianas de media 0 y desviación sigma
+  void fillGaussianBlock(float *noise) {
+    float u1[GAUSSIAN_BLOCK / 2];
+    float u2[GAUSSIAN_BLOCK / 2];
+    
+    // Uniformes en (0, 1]: cada valor de 64 bits da dos uniformes de 24 bits
+    for (int i = 0; i < GAUSSIAN_BLOCK / 2; i++) {
+      uint64_t r = generator.next();
+      u1[i] = ((uint32_t)(r >> 40) + 1.0f) * (1.0f / 16777216.0f);
+      u2[i] = (uint32_t)((r >> 8) & 0xFFFFFF) * (1.0f / 16777216.0f);
+    }
+    
+    // Box-Muller: cada par de uniformes da dos gaussianas independientes
+    for (int i = 0; i < GAUSSIAN_BLOCK / 2; i++) {
+      float radius = sigma * sqrtf(-2.0f * logf(u1[i]));
+      float angle = 6.28318530718f * u2[i];
+      noise[2 * i] = radius * cosf(angle);
+      noise[2 * i + 1] = radius * sinf(angle);
+    }
+  }
+  
+  // Transmite hasta 8 bytes y escribe sus LLR; devuelve los bits que se decidirían mal
+  int transmitBlock(unsigned char *input, int8_t *llr, int bytes) {
+    float noise[GAUSSIAN_BLOCK];
+    fillGaussianBlock(noise);
+    
+    int hardErrors = 0;
+    for (int i = 0; i < bytes * 8; i++) {
+      int bit = (input[i / 8] >> (7 - i % 8)) & 1;
+      float received = (bit ? -1.0f : 1.0f) + noise[i];
+      float value = received * llrGain;
+      value = constrain(value, (float)-LLR_MAX, (float)LLR_MAX);
+      llr[i] = (int8_t)lrintf(value);
+      hardErrors += ((llr[i] < 0) != bit);
+    }
+    return hardErrors;
+  }
+  
+public:
+  /**
+   * Constructor de la clase AwgnChannel.
+   * @param snr Relación señal/ruido por símbolo Es/N0 en dB
+   * @param channelSeed Semilla de 64 bits del generador
+   * @param scale Unidades del LLR cuantizado por cada unidad de LLR (por defecto 4)
+   */
+  AwgnChannel(float snr, uint64_t channelSeed, float scale = 4.0f) {
+    snrDb = snr;
+    llrScale = scale;
+    setSeed(channelSeed);
+    updateParameters();
+  }
+  
+  /**
+   * Envía un paquete y obtiene los LLR de cada bit.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param llr Vector de salida con un LLR int8 por bit (length * 8 elementos)
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de bits que se decodificarían mal con decisión dura
+   */
+  int sendPacketSoft(unsigned char *input, int8_t *llr, int length) {
+    int hardErrors = 0;
+    for (int i = 0; i < length; i += 8) {
+      int bytes = (length - i < 8) ? length - i : 8;
+      hardErrors += transmitBlock(input + i, llr + i * 8, bytes);
+    }
+    return hardErrors;
+  }
+  
+  /**
+   * Envía un paquete y devuelve la decisión dura de cada bit, como NoisyChannel.
+   * La entrada y la salida pueden ser el mismo vector.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector en bytes
+   * @return Número de bits invertidos por el canal
+   */
+  int sendPacket(unsigned char *input, unsigned char *output, int length) {
+    int8_t llr[GAUSSIAN_BLOCK];
+    int hardErrors = 0;
+    for (int i = 0; i < length; i += 8) {
+      int bytes = (length - i < 8) ? length - i : 8;
+      hardErrors += transmitBlock(input + i, llr, bytes);
+      hardDecision(llr, output + i, bytes);
+    }
+    return hardErrors;
+  }
+  
+  /**
+   * Convierte un vector de LLR en bits empaquetados (1 si el LLR es negativo).
+   * @param llr Vector de LLR (length * 8 elementos)
+   * @param output Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de salida en bytes
+   */
+  static void hardDecision(int8_t *llr, unsigned char *output, int length) {
+    for (int i = 0; i < length; i++) {
+      unsigned char value = 0;
+      for (int j = 0; j < 8; j++) {
+        value = (value << 1) | (llr[i * 8 + j] < 0);
+      }
+      output[i] = value;
+    }
+  }
+  
+  /**
+   * Probabilidad de error de bit con decisión dura, Q(sqrt(2 Es/N0)).
+   * Es la f del canal binario simétrico equivalente.
+   * @return Probabilidad de error de bit equivalente
+   */
+  float getEquivalentCrossover() {
+    float snrLinear = powf(10.0f, snrDb / 10.0f);
+    return 0.5f * erfcf(sqrtf(snrLinear));
+  }
+  
+  /**
+   * Obtiene la relación señal/ruido configurada.
+   * @return Es/N0 en dB
+   */
+  float getSnrDb() {
+    return snrDb;
+  }
+  
+  /**
+   * Establece una nueva relación señal/ruido.
+   * @param snr Es/N0 en dB
+   */
+  void setSnrDb(float snr) {
+    snrDb = snr;
+    updateParameters();
+  }
+  
+  /**
+   * Obtiene la escala de cuantización de los LLR.
+   * @return Unidades del LLR cuantizado por cada unidad de LLR
+   */
+  float getLlrScale() {
+    return llrScale;
+  }
+  
+  /**
+   * Establece la escala de cuantización de los LLR.
+   * @param scale Unidades del LLR cuantizado por cada unidad de LLR
+   */
+  void setLlrScale(float scale) {
+    llrScale = scale;
+    updateParameters();
+  }
+  
+  /**
+   * Reinicia el generador del canal con una semilla explícita.
+   * @param channelSeed Semilla de 64 bits
+   */
+  void setSeed(uint64_t channelSeed) {
+    seed = channelSeed;
+    generator.setSeed(seed);
+  }
+  
+  /**
+   * Selecciona la subsecuencia aleatoria número streamIndex de la semilla actual.
+   * @param streamIndex Índice de la subsecuencia
+   */
+  void selectStream(int streamIndex) {
+    generator.setSeed(seed);
+    for (int i = 0; i < streamIndex; i++) {
+      generator.jump();
+    }
+  }
+};
+
+/**
+ * Clase que simula un canal de borrado binario (BEC).
+ * Cada bit se borra con probabilidad e: el receptor sabe qué bits se han perdido pero no
+ * su valor. Además de los bytes recibidos (con los bits borrados a 0), el canal entrega
+ * un mapa de borrados empaquetado igual que los datos, con un bit por bit transmitido,
+ * de modo que la memoria adicional es solo 1/8 del paquete.
+ */
+class ErasureChannel {
+private:
+  NoisyChannel erasureGenerator; // Genera las máscaras de borrado (un 1 = bit borrado)
+  
+public:
+  /**
+   * Constructor de la clase ErasureChannel.
+   * @param erasure Probabilidad de borrado de cada bit (entre 0 y 1)
+   * @param channelSeed Semilla de 64 bits del generador
+   */
+  ErasureChannel(float erasure, uint64_t channelSeed) : erasureGenerator(erasure, channelSeed) {
+  }
+  
+  /**
+   * Envía un paquete a través del canal de borrado.
+   * La entrada y la salida pueden ser el mismo vector.
+   * @param input Vector binario de entrada empaquetado en unsigned char
+   * @param output Vector binario de salida empaquetado en unsigned char (bits borrados a 0)
+   * @param erasures Mapa de borrados de salida, length bytes (bit a 1 = bit borrado)
+   * @param length Longitud del vector en bytes
+   * @return Número de bits borrados
+   */
+  int sendPacket(unsigned char *input, unsigned char *output, unsigned char *erasures, int length) {
+    int erasedBits = 0;
+    
+    for (int i = 0; i < length; i += 8) {
+      uint64_t mask = erasureGenerator.nextErrorMask();
+      int bytes = (length - i < 8) ? length - i : 8;
+      for (int k = 0; k < bytes; k++) {
+        unsigned char byteMask = (mask >> (8 * k)) & 0xFF;
+        erasures[i + k] = byteMask;
+        output[i + k] = input[i + k] & ~byteMask;
+        erasedBits += __builtin_popcount(byteMask);
+      }
+    }
+    return erasedBits;
+  }
+  
+  /**
+   * Obtiene la probabilidad de borrado configurada.
+   * @return Probabilidad de borrado (entre 0 y 1)
+   */
+  float getErasureProbability() {
+    return erasureGenerator.getNoisePercentage();
+  }
+  
+  /**
+   * Establece una nueva probabilidad de borrado.
+   * @param erasure Probabilidad de borrado (entre 0 y 1)
+   */
+  void setErasureProbability(float erasure) {
+    erasureGenerator.setNoisePercentage(erasure);
+  }
+  
+  /**
+   * Reinicia el generador del canal con una semilla explícita.
+   * @param channelSeed Semilla de 64 bits
+   */
+  void setSeed(uint64_t channelSeed) {
+    erasureGenerator.setSeed(channelSeed);
+  }
+  
+  /**
+   * Selecciona la subsecuencia aleatoria número streamIndex de la semilla actual.
+   * @param streamIndex Índice de la subsecuencia
+   */
+  void selectStream(int streamIndex) {
+    erasureGenerator.selectStream(streamIndex);
   }
 };
 
@@ -117,23 +999,12 @@ void setup() {
   Serial.println("Vector de entrada:");
   printBinaryVector(input, length);
   
-  // Enviar el paquete a través del canal ruidoso
-  channel.sendPacket(input, output, length);
+  // Enviar el paquete a través del canal ruidoso (devuelve los bits que han cambiado)
+  int changedBits = channel.sendPacket(input, output, length);
   
   Serial.println("Vector de salida (después del canal ruidoso):");
   printBinaryVector(output, length);
   
-  // Contar bits que han cambiado
-  int changedBits = 0;
-  for (int i = 0; i < length; i++) {
-    unsigned char diff = input[i] ^ output[i]; // XOR para detectar bits diferentes
-    for (int j = 0; j < 8; j++) {
-      if ((diff >> j) & 1) {
-        changedBits++;
-      }
-    }
-  }
-  
   Serial.print("Bits cambiados: ");
   Serial.print(changedBits);
   Serial.print(" de ");
@@ -154,22 +1025,11 @@ void setup() {
   printBinaryVector(input2, length);
   
   // Enviar el paquete a través del canal ruidoso con el nuevo porcentaje
-  channel.sendPacket(input2, output2, length);
+  changedBits = channel.sendPacket(input2, output2, length);
   
   Serial.println("Vector de salida (después del canal ruidoso):");
   printBinaryVector(output2, length);
   
-  // Contar bits que han cambiado
-  changedBits = 0;
-  for (int i = 0; i < length; i++) {
-    unsigned char diff = input2[i] ^ output2[i]; // XOR para detectar bits diferentes
-    for (int j = 0; j < 8; j++) {
-      if ((diff >> j) & 1) {
-        changedBits++;
-      }
-    }
-  }
-  
   Serial.print("Bits cambiados: ");
   Serial.print(changedBits);
   Serial.print(" de ");
@@ -177,6 +1037,77 @@ void setup() {
   Serial.print(" (");
   Serial.print((float)changedBits / (length * 8) * 100);
   Serial.println("%)");
+  
+  // Ejemplo de canal con ráfagas (Gilbert-Elliott): sin errores en G y f = 0.5 en B
+  Serial.println("\nCanal con ráfagas de Gilbert-Elliott");
+  const int burstLength = 4096;
+  static unsigned char burstInput[burstLength];
+  static unsigned char burstOutput[burstLength];
+  GilbertElliottChannel burstChannel(0.001, 0.05, 0.0, 0.5, 12345);
+  
+  changedBits = burstChannel.sendPacket(burstInput, burstOutput, burstLength);
+  
+  Serial.print("Bits cambiados: ");
+  Serial.print(changedBits);
+  Serial.print(" de ");
+  Serial.print(burstLength * 8);
+  Serial.print(" (esperado ");
+  Serial.print(burstChannel.getAverageErrorRate() * 100);
+  Serial.println("%)");
+  Serial.print("Ráfagas: ");
+  Serial.print(burstChannel.getBurstCount());
+  Serial.print(", longitud media: ");
+  Serial.print(burstChannel.getAverageBurstLength());
+  Serial.print(" bits, máxima: ");
+  Serial.println(burstChannel.getLongestBurst());
+  
+  // Histograma de longitudes de ráfaga
+  for (int bin = 0; bin < GilbertElliottChannel::BURST_HISTOGRAM_BINS; bin++) {
+    if (burstChannel.getBurstHistogram(bin) > 0) {
+      Serial.print("  ");
+      Serial.print(1UL << bin);
+      Serial.print("-");
+      Serial.print((2UL << bin) - 1);
+      Serial.print(" bits: ");
+      Serial.println(burstChannel.getBurstHistogram(bin));
+    }
+  }
+  
+  // Ejemplo de canal AWGN con salida blanda: un LLR int8 por bit
+  Serial.println("\nCanal AWGN con salida blanda (Es/N0 = 3 dB)");
+  AwgnChannel awgnChannel(3.0, 12345);
+  int8_t llr[length * 8];
+  
+  changedBits = awgnChannel.sendPacketSoft(input, llr, length);
+  
+  Serial.println("LLR recibidos:");
+  for (int i = 0; i < length * 8; i++) {
+    Serial.print(llr[i]);
+    Serial.print((i % 8 == 7) ? "\n" : " ");
+  }
+  Serial.print("Bits erróneos con decisión dura: ");
+  Serial.print(changedBits);
+  Serial.print(" de ");
+  Serial.print(length * 8);
+  Serial.print(" (f equivalente ");
+  Serial.print(awgnChannel.getEquivalentCrossover() * 100);
+  Serial.println("%)");
+  
+  // Ejemplo de canal de borrado: 20% de bits borrados
+  Serial.println("\nCanal de borrado (e = 0.2)");
+  ErasureChannel erasureChannel(0.2, 12345);
+  unsigned char erasures[length];
+  
+  changedBits = erasureChannel.sendPacket(input, output, erasures, length);
+  
+  Serial.println("Vector de salida (bits borrados a 0):");
+  printBinaryVector(output, length);
+  Serial.println("Mapa de borrados:");
+  printBinaryVector(erasures, length);
+  Serial.print("Bits borrados: ");
+  Serial.print(changedBits);
+  Serial.print(" de ");
+  Serial.println(length * 8);
 }
 
 void loop() {
@@ -6,38 +6,193 @@
  * por repetición en una clase reutilizable.
  */
 #include <Arduino.h>
+#include <string.h>
+
+#ifndef DECODER_STATS
+#define DECODER_STATS 0 // Con -DDECODER_STATS=1 los decodificadores llevan contadores internos
+#endif
+
+#if DECODER_STATS
+#include <atomic>
 
 /**
- * Clase que implementa un codificador y decodificador de repetición.
- * Permite codificar mensajes repitiendo cada bit n veces y decodificarlos
- * mediante un sistema de votación por mayoría.
+ * Contadores de un decodificador con una copia por hilo. Cada hilo incrementa solo su
+ * ranura, alineada a una línea de caché para que dos hilos no escriban en la misma línea,
+ * así que el decodificador no necesita operaciones atómicas; al leer se suman todas las
+ * ranuras. Counters tiene que ser un struct de enteros con un método merge.
+ * Pueden decodificar a la vez como máximo MAX_THREADS hilos.
  */
-class RepetitionCode {
+template <class Counters>
+class DecoderStats {
+public:
+  static const int MAX_THREADS = 8; // Número de ranuras
+  static const int CACHE_LINE = 64; // Tamaño de una línea de caché en bytes
+  
+private:
+  // Contadores de un hilo, en sus propias líneas de caché
+  struct alignas(CACHE_LINE) Slot {
+    Counters counters;
+  };
+  
+  Slot slots[MAX_THREADS];
+  
+  /**
+   * Método auxiliar que asigna una ranura a cada hilo la primera vez que la pide
+   * @return Índice de la ranura del hilo actual
+   */
+  static int threadSlot() {
+    static std::atomic<int> nextSlot(0);
+    static thread_local int slot = nextSlot.fetch_add(1) % MAX_THREADS;
+    return slot;
+  }
+  
+public:
+  /**
+   * Constructor de la clase: todos los contadores empiezan a 0
+   */
+  DecoderStats() : slots() {
+  }
+  
+  /**
+   * Método para obtener los contadores del hilo actual
+   * @return Contadores de la ranura del hilo
+   */
+  Counters &local() {
+    return slots[threadSlot()].counters;
+  }
+  
+  /**
+   * Método para obtener la suma de los contadores de todos los hilos
+   * @return Contadores acumulados
+   */
+  Counters read() const {
+    Counters total = Counters();
+    for (int i = 0; i < MAX_THREADS; i++) {
+      total.merge(slots[i].counters);
+    }
+    return total;
+  }
+  
+  /**
+   * Método para poner a 0 todos los contadores
+   */
+  void reset() {
+    for (int i = 0; i < MAX_THREADS; i++) {
+      slots[i] = Slot();
+    }
+  }
+};
+#endif
+
+/**
+ * Contadores del decodificador de repetición (ver DECODER_STATS). Una votación es unánime
+ * si todas las copias del bit coinciden; si está dividida, el canal ha cambiado al menos
+ * una copia, aunque la mayoría lo corrija.
+ */
+struct RepetitionCounters {
+  uint32_t unanimousVotes; // Votaciones con todas las copias iguales
+  uint32_t splitVotes;     // Votaciones con alguna copia distinta
+  
+  /**
+   * Método para añadir una votación
+   * @param unanimous true si todas las copias coinciden
+   */
+  void addVote(bool unanimous) {
+    if (unanimous) {
+      unanimousVotes++;
+    } else {
+      splitVotes++;
+    }
+  }
+  
+  /**
+   * Método para añadir hasta 64 votaciones calculadas en paralelo
+   * @param allOnes AND de las copias (1 donde todas valen 1)
+   * @param anyOnes OR de las copias (1 donde alguna vale 1)
+   * @param valid Máscara de las posiciones que son votaciones reales
+   */
+  void addVotes(uint64_t allOnes, uint64_t anyOnes, uint64_t valid) {
+    int unanimous = __builtin_popcountll((allOnes | ~anyOnes) & valid);
+    unanimousVotes += unanimous;
+    splitVotes += __builtin_popcountll(valid) - unanimous;
+  }
+  
+  /**
+   * Método para acumular los contadores de otro hilo
+   * @param other Contadores a sumar
+   */
+  void merge(const RepetitionCounters &other) {
+    unanimousVotes += other.unanimousVotes;
+    splitVotes += other.splitVotes;
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal. Una votación es unánime si no
+   * falla ninguna de las n copias, con probabilidad (1 - f)^n (se desprecia el caso de que
+   * fallen todas), así que f = 1 - (unánimes / total)^(1/n).
+   * @param copies Grado de repetición n
+   * @return Estimación de f (0 si no hay votaciones)
+   */
+  float estimateErrorRate(int copies) const {
+    uint32_t votes = unanimousVotes + splitVotes;
+    if (votes == 0) {
+      return 0;
+    }
+    return 1 - powf((float)unanimousVotes / votes, 1.0f / copies);
+  }
+};
+
+/**
+ * Clase que implementa la codificación y decodificación por repetición válida para
+ * cualquier grado. Es la implementación de referencia y la que usa RepetitionCode
+ * cuando no existe una versión especializada para el grado elegido.
+ */
+class GenericRepetitionCode {
 private:
   int repetitionDegree; // Grado de repetición (número de veces que se repite cada bit)
   
+  // Valor absoluto máximo de la fiabilidad (cabe en un int8_t)
+  static const int RELIABILITY_MAX = 127;
+  
   /**
-   * Método auxiliar para imprimir un vector de bytes en formato binario
-   * @param vec Vector a imprimir
-   * @param length Longitud del vector en bytes
+   * Método auxiliar que limita una fiabilidad al rango de un int8_t
+   * @param margin Margen de la votación
+   * @return Margen limitado a [-RELIABILITY_MAX, RELIABILITY_MAX]
    */
-  void printBinaryVector(unsigned char *vec, int length) {
-    for (int i = 0; i < length; i++) {
-      for (int j = 7; j >= 0; j--) {
-        // Extraer y mostrar cada bit, empezando por el más significativo
-        Serial.print((vec[i] >> j) & 1);
-      }
-      Serial.print(" ");
+  static int clampReliability(int margin) {
+    if (margin > RELIABILITY_MAX) {
+      return RELIABILITY_MAX;
     }
-    Serial.println();
+    if (margin < -RELIABILITY_MAX) {
+      return -RELIABILITY_MAX;
+    }
+    return margin;
   }
   
+  // Tabla que reparte los 8 bits de un byte en 8 carriles de un byte: el carril k (el byte k
+  // en memoria) vale 1 si el bit 7 - k del byte vale 1. Se genera en tiempo de compilación
+  struct SpreadTable {
+    uint64_t lanes[256];
+    
+    constexpr SpreadTable() : lanes() {
+      for (int v = 0; v < 256; v++) {
+        for (int k = 0; k < 8; k++) {
+          int shift = (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) ? 8 * k : 8 * (7 - k);
+          lanes[v] |= (uint64_t)((v >> (7 - k)) & 1) << shift;
+        }
+      }
+    }
+  };
+  
+  // Se define después de la clase, cuando SpreadTable ya está completa
+  static const SpreadTable SPREAD_TABLE;
+  
 public:
   /**
    * Constructor de la clase
    * @param n Grado de repetición (número de veces que se repite cada bit)
    */
-  RepetitionCode(int n) {
+  GenericRepetitionCode(int n) {
     repetitionDegree = n;
   }
   
@@ -73,6 +228,82 @@ public:
    * @param length Longitud del vector de entrada en bytes
    */
   void encode(unsigned char *in, unsigned char *out, int length) {
+    encodeBits(in, out, length, repetitionDegree);
+  }
+  
+  /**
+   * Método para decodificar un mensaje codificado con repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decode(unsigned char *in, unsigned char *out, int length) {
+    decodeBits(in, out, length, repetitionDegree);
+  }
+  
+  /**
+   * Método para decodificar un mensaje recibido por un canal de borrado.
+   * La votación solo tiene en cuenta las copias que no se han borrado; si se han borrado
+   * todas las copias de un bit, no se puede recuperar y se decodifica como 0.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de bits que no se han podido recuperar
+   */
+  int decodeErasures(unsigned char *in, unsigned char *erasures, unsigned char *out, int length) {
+    int inBitIndex = 0;  // Índice del bit actual en el vector de entrada
+    int outBitIndex = 0; // Índice del bit actual en el vector de salida
+    int lostBits = 0;    // Bits con todas sus copias borradas
+    
+    // Inicializar el vector de salida a ceros
+    int outLength = (length * 8) / repetitionDegree; // Número total de bits en el mensaje original
+    int outBytes = (outLength + 7) / 8; // Número de bytes necesarios para almacenar el mensaje original
+    
+    for (int i = 0; i < outBytes; i++) {
+      out[i] = 0;
+    }
+    
+    // Procesar cada grupo de n bits repetidos
+    while (inBitIndex + repetitionDegree <= length * 8) {
+      int countOnes = 0;  // Copias no borradas que valen 1
+      int countZeros = 0; // Copias no borradas que valen 0
+      
+      for (int k = 0; k < repetitionDegree; k++) {
+        int inByteIndex = inBitIndex / 8;
+        int inBitPosition = 7 - (inBitIndex % 8);
+        
+        // Solo votan las copias que no se han borrado
+        if (((erasures[inByteIndex] >> inBitPosition) & 1) == 0) {
+          if ((in[inByteIndex] >> inBitPosition) & 1) {
+            countOnes++;
+          } else {
+            countZeros++;
+          }
+        }
+        inBitIndex++;
+      }
+      
+      if (countOnes + countZeros == 0) {
+        lostBits++;
+      }
+      
+      // Votación por mayoría entre las copias recibidas
+      unsigned char decodedBit = (countOnes > countZeros) ? 1 : 0;
+      out[outBitIndex / 8] |= (decodedBit << (7 - (outBitIndex % 8)));
+      outBitIndex++;
+    }
+    return lostBits;
+  }
+  
+  /**
+   * Método que codifica bit a bit con cualquier grado de repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void encodeBits(unsigned char *in, unsigned char *out, int length, int n) {
     int outBitIndex = 0; // Índice del bit actual en el vector de salida
     
     // Recorrer cada byte del vector de entrada
@@ -83,7 +314,7 @@ public:
         unsigned char bit = (in[i] >> j) & 1;
         
         // Repetir el bit n veces
-        for (int k = 0; k < repetitionDegree; k++) {
+        for (int k = 0; k < n; k++) {
           // Calcular el índice del byte de salida donde se colocará el bit repetido
           int outByteIndex = outBitIndex / 8;
           // Calcular la posición del bit dentro del byte de salida
@@ -105,17 +336,19 @@ public:
   }
   
   /**
-   * Método para decodificar un mensaje codificado con repetición
+   * Método que decodifica bit a bit con cualquier grado de repetición
    * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
    * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
    * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
    */
-  void decode(unsigned char *in, unsigned char *out, int length) {
+  static void decodeBits(unsigned char *in, unsigned char *out, int length, int n, RepetitionCounters *counters = NULL) {
     int inBitIndex = 0;  // Índice del bit actual en el vector de entrada
     int outBitIndex = 0; // Índice del bit actual en el vector de salida
     
     // Inicializar el vector de salida a ceros
-    int outLength = (length * 8) / repetitionDegree; // Número total de bits en el mensaje original
+    int outLength = (length * 8) / n; // Número total de bits en el mensaje original
     int outBytes = (outLength + 7) / 8; // Número de bytes necesarios para almacenar el mensaje original
     
     for (int i = 0; i < outBytes; i++) {
@@ -125,9 +358,10 @@ public:
     // Procesar cada grupo de n bits repetidos
     while (inBitIndex < length * 8) {
       int countOnes = 0; // Contador de unos en el grupo actual
+      int copies = 0;    // Copias leídas (el último grupo puede estar incompleto)
       
       // Contar cuántos unos hay en el grupo de n bits
-      for (int k = 0; k < repetitionDegree && inBitIndex < length * 8; k++) {
+      for (int k = 0; k < n && inBitIndex < length * 8; k++) {
         // Calcular el índice del byte de entrada y la posición del bit
         int inByteIndex = inBitIndex / 8;
         int inBitPosition = 7 - (inBitIndex % 8);
@@ -142,10 +376,19 @@ public:
         
         // Avanzar al siguiente bit de entrada
         inBitIndex++;
+        copies++;
+      }
+      
+#if DECODER_STATS
+      if (counters != NULL) {
+        counters->addVote(countOnes == 0 || countOnes == copies);
       }
+#else
+      (void)counters;
+#endif
       
       // Determinar el bit original mediante votación por mayoría
-      unsigned char decodedBit = (countOnes > repetitionDegree / 2) ? 1 : 0;
+      unsigned char decodedBit = (countOnes > n / 2) ? 1 : 0;
       
       // Calcular el índice del byte de salida y la posición del bit
       int outByteIndex = outBitIndex / 8;
@@ -159,6 +402,830 @@ public:
     }
   }
   
+  /**
+   * Método que codifica con disposición por bloques: el bloque completo se repite n veces
+   * seguidas, de modo que las copias de un mismo bit quedan separadas length bytes
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void encodeBlocks(unsigned char *in, unsigned char *out, int length, int n) {
+    for (int k = 0; k < n; k++) {
+      memcpy(out + k * length, in, length);
+    }
+  }
+  
+  /**
+   * Método que decodifica un mensaje con disposición por bloques. La votación se hace
+   * palabra a palabra (64 bits) con un contador binario en paralelo sobre las n copias,
+   * sin tener que separar ni recolocar bits.
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decodeBlocks(unsigned char *in, unsigned char *out, int length, int n, RepetitionCounters *counters = NULL) {
+    int blockLength = length / n; // Longitud de cada copia del bloque en bytes
+    
+    // Bits necesarios para contar hasta n
+    int countBits = 1;
+    while ((n >> countBits) != 0) {
+      countBits++;
+    }
+    
+    for (int offset = 0; offset < blockLength; offset += 8) {
+      int bytes = (blockLength - offset < 8) ? blockLength - offset : 8;
+      uint64_t count[32] = {0}; // count[b] es el bit b del número de unos de cada posición
+#if DECODER_STATS
+      uint64_t allOnes = ~(uint64_t)0; // Posiciones en las que todas las copias valen 1
+      uint64_t anyOnes = 0;            // Posiciones en las que alguna copia vale 1
+#endif
+      
+      for (int k = 0; k < n; k++) {
+        uint64_t carry = 0;
+        memcpy(&carry, in + k * blockLength + offset, bytes);
+#if DECODER_STATS
+        allOnes &= carry;
+        anyOnes |= carry;
+#endif
+        for (int b = 0; b < countBits && carry != 0; b++) {
+          uint64_t nextCarry = count[b] & carry;
+          count[b] ^= carry;
+          carry = nextCarry;
+        }
+      }
+      
+#if DECODER_STATS
+      if (counters != NULL) {
+        uint64_t valid = 0;
+        memset(&valid, 0xFF, bytes);
+        counters->addVotes(allOnes, anyOnes, valid);
+      }
+#else
+      (void)counters;
+#endif
+      
+      uint64_t decoded = atLeast(count, countBits, n / 2 + 1);
+      memcpy(out + offset, &decoded, bytes);
+    }
+  }
+  
+  /**
+   * Método que decodifica con disposición por bloques un mensaje recibido por un canal
+   * de borrado. Solo votan las copias que no se han borrado.
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   * @return Número de bits que no se han podido recuperar
+   */
+  static int decodeErasuresBlocks(unsigned char *in, unsigned char *erasures, unsigned char *out, int length, int n) {
+    int blockLength = length / n; // Longitud de cada copia del bloque en bytes
+    int lostBits = 0;             // Bits con todas sus copias borradas
+    
+    for (int i = 0; i < blockLength; i++) {
+      out[i] = 0;
+      for (int j = 7; j >= 0; j--) {
+        int countOnes = 0;  // Copias no borradas que valen 1
+        int countZeros = 0; // Copias no borradas que valen 0
+        
+        for (int k = 0; k < n; k++) {
+          int byteIndex = k * blockLength + i;
+          if (((erasures[byteIndex] >> j) & 1) == 0) {
+            if ((in[byteIndex] >> j) & 1) {
+              countOnes++;
+            } else {
+              countZeros++;
+            }
+          }
+        }
+        
+        if (countOnes + countZeros == 0) {
+          lostBits++;
+        }
+        if (countOnes > countZeros) {
+          out[i] |= 1 << j;
+        }
+      }
+    }
+    return lostBits;
+  }
+  
+  /**
+   * Método que decodifica bit a bit y además devuelve la fiabilidad de cada bit decodificado,
+   * calculada como el margen de la votación: copias a 0 menos copias a 1. Sigue el mismo
+   * convenio de signo que un LLR (positivo = 0, negativo = 1) y su valor absoluto indica lo
+   * clara que ha sido la mayoría. Las copias de cada bit se cuentan con popcount sobre
+   * palabras de hasta 56 bits en lugar de extraerlas una a una.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param reliability Fiabilidad de cada bit decodificado (un int8_t por bit)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void decodeSoftBits(unsigned char *in, unsigned char *out, int8_t *reliability, int length, int n) {
+    int outLength = (length * 8) / n; // Número de grupos completos de n bits
+    int outBitIndex = 0;              // Índice del bit actual en el vector de salida
+    int inByteIndex = 0;              // Siguiente byte de entrada por leer
+    
+    // Caso habitual (n <= 8): 8 bits decodificados ocupan exactamente n bytes de entrada,
+    // que caben en una palabra de 64 bits, y cada grupo se cuenta con una máscara
+    if (n <= 8) {
+      uint64_t groupMask = ((uint64_t)1 << n) - 1;
+      for (; outBitIndex + 8 <= outLength; outBitIndex += 8) {
+        uint64_t word = 0;
+        for (int k = 0; k < n; k++) {
+          word = (word << 8) | in[inByteIndex++];
+        }
+        
+        unsigned char outByte = 0;
+        for (int g = 0; g < 8; g++) {
+          int countOnes = __builtin_popcountll((word >> (n * (7 - g))) & groupMask);
+          int margin = n - 2 * countOnes;
+          reliability[outBitIndex + g] = (int8_t)clampReliability(margin);
+          outByte = (outByte << 1) | (margin < 0);
+        }
+        out[outBitIndex / 8] = outByte;
+      }
+    }
+    
+    // Resto de grupos (o todos si n > 8): lectura continua a través de un buffer
+    uint64_t buffer = 0;       // Bits pendientes de leer, alineados a la izquierda
+    int bufferBits = 0;        // Número de bits válidos en buffer
+    unsigned char outByte = 0; // Byte de salida en construcción
+    
+    for (; outBitIndex < outLength; outBitIndex++) {
+      int countOnes = 0;
+      int remaining = n;
+      
+      while (remaining > 0) {
+        // Rellenar el buffer byte a byte mientras quepa un byte más
+        while (bufferBits <= 56 && inByteIndex < length) {
+          buffer |= (uint64_t)in[inByteIndex++] << (56 - bufferBits);
+          bufferBits += 8;
+        }
+        
+        int take = (remaining < 56) ? remaining : 56;
+        countOnes += __builtin_popcountll(buffer >> (64 - take));
+        buffer <<= take;
+        bufferBits -= take;
+        remaining -= take;
+      }
+      
+      int margin = n - 2 * countOnes;
+      reliability[outBitIndex] = (int8_t)clampReliability(margin);
+      
+      // El bit decodificado se añade sin saltos condicionales y el byte se escribe entero
+      outByte = (outByte << 1) | (margin < 0);
+      if ((outBitIndex % 8) == 7) {
+        out[outBitIndex / 8] = outByte;
+      }
+    }
+    
+    // Último byte incompleto, alineado a la izquierda
+    if ((outLength % 8) != 0) {
+      out[outLength / 8] = outByte << (8 - outLength % 8);
+    }
+  }
+  
+  /**
+   * Método que decodifica con disposición por bloques y además devuelve la fiabilidad de
+   * cada bit decodificado (copias a 0 menos copias a 1, con el convenio de signo de un LLR).
+   * Los votos se acumulan con el mismo contador binario en paralelo que decodeBlocks.
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param reliability Fiabilidad de cada bit decodificado (un int8_t por bit)
+   * @param length Longitud del vector de entrada en bytes
+   * @param n Grado de repetición
+   */
+  static void decodeSoftBlocks(unsigned char *in, unsigned char *out, int8_t *reliability, int length, int n) {
+    int blockLength = length / n; // Longitud de cada copia del bloque en bytes
+    
+    // Bits necesarios para contar hasta n
+    int countBits = 1;
+    while ((n >> countBits) != 0) {
+      countBits++;
+    }
+    
+    for (int offset = 0; offset < blockLength; offset += 8) {
+      int bytes = (blockLength - offset < 8) ? blockLength - offset : 8;
+      uint64_t count[32] = {0}; // count[b] es el bit b del número de unos de cada posición
+      
+      for (int k = 0; k < n; k++) {
+        uint64_t carry = 0;
+        memcpy(&carry, in + k * blockLength + offset, bytes);
+        for (int b = 0; b < countBits && carry != 0; b++) {
+          uint64_t nextCarry = count[b] & carry;
+          count[b] ^= carry;
+          carry = nextCarry;
+        }
+      }
+      
+      uint64_t decoded = atLeast(count, countBits, n / 2 + 1);
+      memcpy(out + offset, &decoded, bytes);
+      
+      // Si n <= RELIABILITY_MAX cada cuenta cabe en un byte: los planos del contador se
+      // reparten en carriles de un byte y los 8 márgenes de cada byte se calculan a la vez.
+      // n + 128 - 2 * cuenta está entre 1 y 255, así que la resta no pasa de un carril a otro,
+      // y el XOR con 0x80 lo convierte en n - 2 * cuenta en complemento a dos
+      if (n <= RELIABILITY_MAX) {
+        const uint64_t LANES = 0x0101010101010101ULL;
+        uint64_t bias = (uint64_t)(n + 128) * LANES;
+        for (int i = 0; i < bytes; i++) {
+          uint64_t counts = 0;
+          for (int b = 0; b < countBits; b++) {
+            counts |= SPREAD_TABLE.lanes[((unsigned char *)&count[b])[i]] << b;
+          }
+          uint64_t margins = (bias - (counts << 1)) ^ (0x80 * LANES);
+          memcpy(reliability + (offset + i) * 8, &margins, 8);
+        }
+      } else {
+        // Grados mayores: la cuenta no cabe en un byte y se lee posición a posición
+        for (int i = 0; i < bytes; i++) {
+          for (int j = 7; j >= 0; j--) {
+            int countOnes = 0;
+            for (int b = 0; b < countBits; b++) {
+              countOnes |= ((((unsigned char *)&count[b])[i] >> j) & 1) << b;
+            }
+            reliability[(offset + i) * 8 + (7 - j)] = (int8_t)clampReliability(n - 2 * countOnes);
+          }
+        }
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que compara un contador binario en paralelo con un umbral
+   * @param count Contador binario (count[b] es el bit b de la cuenta de cada posición)
+   * @param countBits Número de bits del contador
+   * @param threshold Umbral
+   * @return Palabra con un 1 en las posiciones cuya cuenta es mayor o igual que el umbral
+   */
+  static uint64_t atLeast(const uint64_t *count, int countBits, int threshold) {
+    uint64_t greater = 0;
+    uint64_t equal = ~(uint64_t)0;
+    
+    // Comparar del bit más significativo al menos significativo
+    for (int b = countBits - 1; b >= 0; b--) {
+      if ((threshold >> b) & 1) {
+        equal &= count[b];
+      } else {
+        greater |= equal & count[b];
+        equal &= ~count[b];
+      }
+    }
+    return greater | equal;
+  }
+};
+
+constexpr GenericRepetitionCode::SpreadTable GenericRepetitionCode::SPREAD_TABLE = GenericRepetitionCode::SpreadTable();
+
+/**
+ * Clase que implementa un código de repetición con el grado N fijado en tiempo de compilación.
+ * Las tablas se generan en tiempo de compilación (constexpr) y los bucles sobre las N copias
+ * tienen un número de vueltas constante, así que se desenrollan y el umbral de la votación
+ * y la longitud codificada se conocen de antemano.
+ *
+ * - Codificación: cada byte de entrada se convierte exactamente en N bytes de salida, que
+ *   se copian de una tabla de 256 x N bytes.
+ * - Decodificación: cada bloque de 64 bits decodificados se separa en N planos de 64 bits
+ *   (uno por copia) y la votación por mayoría se hace con operaciones lógicas.
+ */
+template <int N>
+class FixedRepetitionCode {
+private:
+  // Palabras de 64 bits necesarias para guardar un byte por cada copia
+  static const int LANE_WORDS = (N + 7) / 8;
+  
+  // Tablas de codificación y de separación en planos, generadas en tiempo de compilación
+  struct Tables {
+    // Los N bytes codificados de cada valor de byte
+    unsigned char encodedBytes[256][N];
+    // Para el byte b de un grupo de N bytes (8 bits decodificados) con valor v, el byte k
+    // de planeLanes[b][v] contiene los bits que ese byte aporta a la copia k
+    uint64_t planeLanes[N][256][LANE_WORDS];
+    
+    constexpr Tables() : encodedBytes(), planeLanes() {
+      for (int v = 0; v < 256; v++) {
+        for (int i = 0; i < 8 * N; i++) {
+          // El bit i de la salida es una copia del bit i / N de la entrada
+          if ((v >> (7 - i / N)) & 1) {
+            encodedBytes[v][i / 8] |= 1 << (7 - i % 8);
+          }
+        }
+      }
+      for (int b = 0; b < N; b++) {
+        for (int v = 0; v < 256; v++) {
+          for (int i = 0; i < 8; i++) {
+            if ((v >> (7 - i)) & 1) {
+              int groupBit = 8 * b + i;      // Posición del bit dentro del grupo
+              int decodedBit = groupBit / N; // Bit decodificado al que pertenece
+              int copy = groupBit % N;       // Copia (plano) a la que pertenece
+              planeLanes[b][v][copy / 8] |= (uint64_t)1 << (8 * (copy % 8) + 7 - decodedBit);
+            }
+          }
+        }
+      }
+    }
+  };
+  
+  static constexpr Tables TABLES = Tables();
+  
+  /**
+   * Método auxiliar que calcula la mayoría de los N planos con operaciones lógicas
+   * @param planes Planos de bits, uno por copia
+   * @return Palabra con un 1 donde más de la mitad de los planos valen 1
+   */
+  static uint64_t majority(const uint64_t *planes) {
+    if (N == 3) {
+      return (planes[0] & planes[1]) | (planes[2] & (planes[0] ^ planes[1]));
+    }
+    
+    // Contador binario en paralelo: count[b] es el bit b del número de unos de cada posición
+    const int COUNT_BITS = (N < 4) ? 2 : (N < 8) ? 3 : 4;
+    uint64_t count[COUNT_BITS] = {0};
+#pragma GCC unroll 16
+    for (int k = 0; k < N; k++) {
+      uint64_t carry = planes[k];
+#pragma GCC unroll 4
+      for (int b = 0; b < COUNT_BITS; b++) {
+        uint64_t nextCarry = count[b] & carry;
+        count[b] ^= carry;
+        carry = nextCarry;
+      }
+    }
+    
+    // Comparar el contador con el umbral N / 2 + 1, del bit más significativo al menos
+    const int THRESHOLD = N / 2 + 1;
+    uint64_t greater = 0;
+    uint64_t equal = ~(uint64_t)0;
+#pragma GCC unroll 4
+    for (int b = COUNT_BITS - 1; b >= 0; b--) {
+      if ((THRESHOLD >> b) & 1) {
+        equal &= count[b];
+      } else {
+        greater |= equal & count[b];
+        equal &= ~count[b];
+      }
+    }
+    return greater | equal;
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método auxiliar que cuenta las votaciones unánimes y divididas de los N planos
+   * @param planes Planos de bits, uno por copia
+   * @param valid Máscara de las posiciones que son votaciones reales
+   * @param counters Contadores a actualizar
+   */
+  static void countVotes(const uint64_t *planes, uint64_t valid, RepetitionCounters *counters) {
+    uint64_t allOnes = planes[0];
+    uint64_t anyOnes = planes[0];
+#pragma GCC unroll 16
+    for (int k = 1; k < N; k++) {
+      allOnes &= planes[k];
+      anyOnes |= planes[k];
+    }
+    counters->addVotes(allOnes, anyOnes, valid);
+  }
+#endif
+  
+public:
+  /**
+   * Método para obtener el grado de repetición
+   * @return Grado de repetición
+   */
+  static constexpr int getRepetitionDegree() {
+    return N;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje codificado en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud del mensaje codificado en bytes
+   */
+  static constexpr int getEncodedLength(int originalLength) {
+    return originalLength * N; // 8 * N bits por byte, siempre un número entero de bytes
+  }
+  
+  /**
+   * Método para codificar un mensaje utilizando repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  static void encode(unsigned char *in, unsigned char *out, int length) {
+    for (int i = 0; i < length; i++) {
+      memcpy(out + i * N, TABLES.encodedBytes[in[i]], N);
+    }
+  }
+  
+  /**
+   * Método para decodificar GROUPS grupos seguidos de N bytes (hasta 8). Cada grupo lleva
+   * 8 bits del mensaje original, así que el resultado cabe en una palabra de 64 bits y se
+   * puede seguir procesando sin escribirlo en memoria.
+   * @param in Vector binario de entrada empaquetado en unsigned char (GROUPS * N bytes)
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   * @return Bits decodificados, con el primer grupo en el byte más significativo
+   */
+  template <int GROUPS>
+  static uint64_t decodeGroups(const unsigned char *in, RepetitionCounters *counters = NULL) {
+    uint64_t planes[N] = {0};
+    
+    // Cada grupo de N bytes aporta 8 bits a cada plano
+#pragma GCC unroll 8
+    for (int g = 0; g < GROUPS; g++) {
+      uint64_t lanes[LANE_WORDS] = {0};
+#pragma GCC unroll 16
+      for (int b = 0; b < N; b++) {
+#pragma GCC unroll 2
+        for (int w = 0; w < LANE_WORDS; w++) {
+          lanes[w] |= TABLES.planeLanes[b][in[g * N + b]][w];
+        }
+      }
+#pragma GCC unroll 16
+      for (int k = 0; k < N; k++) {
+        planes[k] |= ((lanes[k / 8] >> (8 * (k % 8))) & 0xFF) << (56 - 8 * g);
+      }
+    }
+    
+#if DECODER_STATS
+    if (counters != NULL) {
+      countVotes(planes, ~(uint64_t)0 << (64 - 8 * GROUPS), counters);
+    }
+#else
+    (void)counters;
+#endif
+    
+    return majority(planes);
+  }
+  
+  /**
+   * Método para decodificar un mensaje codificado con repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decode(unsigned char *in, unsigned char *out, int length, RepetitionCounters *counters = NULL) {
+    int blocks = length / (8 * N); // Bloques completos de 64 bits decodificados
+    
+    for (int block = 0; block < blocks; block++) {
+      uint64_t decoded = decodeGroups<8>(in + block * 8 * N, counters);
+      for (int g = 0; g < 8; g++) {
+        out[block * 8 + g] = (unsigned char)(decoded >> (56 - 8 * g));
+      }
+    }
+    
+    // Los bytes que no completan un bloque se decodifican bit a bit
+    GenericRepetitionCode::decodeBits(in + blocks * 8 * N, out + blocks * 8, length - blocks * 8 * N, N, counters);
+  }
+  
+  /**
+   * Método para codificar con disposición por bloques (el bloque completo se repite N veces)
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  static void encodeBlocks(unsigned char *in, unsigned char *out, int length) {
+#pragma GCC unroll 16
+    for (int k = 0; k < N; k++) {
+      memcpy(out + k * length, in, length);
+    }
+  }
+  
+  /**
+   * Método para decodificar un mensaje con disposición por bloques. Las N copias de cada
+   * palabra de 64 bits ya son los planos de la votación, así que no hay que separar bits.
+   * @param in Vector binario de entrada empaquetado en unsigned char (N copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param counters Contadores de la votación (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decodeBlocks(unsigned char *in, unsigned char *out, int length, RepetitionCounters *counters = NULL) {
+    int blockLength = length / N; // Longitud de cada copia del bloque en bytes
+    
+    for (int offset = 0; offset < blockLength; offset += 8) {
+      int bytes = (blockLength - offset < 8) ? blockLength - offset : 8;
+      uint64_t planes[N] = {0};
+      
+#pragma GCC unroll 16
+      for (int k = 0; k < N; k++) {
+        memcpy(&planes[k], in + k * blockLength + offset, bytes);
+      }
+      
+#if DECODER_STATS
+      if (counters != NULL) {
+        uint64_t valid = 0;
+        memset(&valid, 0xFF, bytes);
+        countVotes(planes, valid, counters);
+      }
+#else
+      (void)counters;
+#endif
+      
+      uint64_t decoded = majority(planes);
+      memcpy(out + offset, &decoded, bytes);
+    }
+  }
+};
+
+/**
+ * Clase que implementa un codificador y decodificador de repetición.
+ * Permite codificar mensajes repitiendo cada bit n veces y decodificarlos
+ * mediante un sistema de votación por mayoría.
+ *
+ * El grado se elige en tiempo de ejecución: para los grados 3, 5, 7 y 9 se usa la versión
+ * especializada FixedRepetitionCode<N> y para el resto la implementación bit a bit
+ * GenericRepetitionCode.
+ *
+ * Admite dos disposiciones de las copias:
+ * - LAYOUT_BIT: cada bit se repite n veces seguidas (disposición original).
+ * - LAYOUT_BLOCK: el bloque completo se repite n veces. Las copias de un mismo bit quedan
+ *   separadas la longitud del bloque, así que una ráfaga de errores solo afecta a una copia,
+ *   y codificar y decodificar no requiere mover bits de sitio.
+ */
+class RepetitionCode {
+public:
+  // Disposición de las copias en el mensaje codificado
+  enum Layout {
+    LAYOUT_BIT,  // Cada bit se repite n veces seguidas
+    LAYOUT_BLOCK // El bloque completo se repite n veces
+  };
+  
+private:
+  int repetitionDegree; // Grado de repetición (número de veces que se repite cada bit)
+  Layout layout;        // Disposición de las copias
+  GenericRepetitionCode genericCoder; // Implementación para los grados no especializados
+#if DECODER_STATS
+  DecoderStats<RepetitionCounters> stats; // Contadores de la votación, uno por hilo
+#endif
+  
+  /**
+   * Método auxiliar que devuelve los contadores del hilo actual
+   * @return Contadores del hilo, o NULL si DECODER_STATS está a 0
+   */
+  RepetitionCounters *localCounters() {
+#if DECODER_STATS
+    return &stats.local();
+#else
+    return NULL;
+#endif
+  }
+  
+  /**
+   * Método auxiliar para imprimir un vector de bytes en formato binario
+   * @param vec Vector a imprimir
+   * @param length Longitud del vector en bytes
+   */
+  void printBinaryVector(unsigned char *vec, int length) {
+    for (int i = 0; i < length; i++) {
+      for (int j = 7; j >= 0; j--) {
+        // Extraer y mostrar cada bit, empezando por el más significativo
+        Serial.print((vec[i] >> j) & 1);
+      }
+      Serial.print(" ");
+    }
+    Serial.println();
+  }
+  
+  /**
+   * Método auxiliar que codifica con disposición por bloques
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void encodeBlocks(unsigned char *in, unsigned char *out, int length) {
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::encodeBlocks(in, out, length);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::encodeBlocks(in, out, length);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::encodeBlocks(in, out, length);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::encodeBlocks(in, out, length);
+        break;
+      default:
+        GenericRepetitionCode::encodeBlocks(in, out, length, repetitionDegree);
+        break;
+    }
+  }
+  
+  /**
+   * Método auxiliar que decodifica con disposición por bloques
+   * @param in Vector binario de entrada empaquetado en unsigned char (n copias del bloque)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decodeBlocks(unsigned char *in, unsigned char *out, int length) {
+    RepetitionCounters *counters = localCounters();
+    
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::decodeBlocks(in, out, length, counters);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::decodeBlocks(in, out, length, counters);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::decodeBlocks(in, out, length, counters);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::decodeBlocks(in, out, length, counters);
+        break;
+      default:
+        GenericRepetitionCode::decodeBlocks(in, out, length, repetitionDegree, counters);
+        break;
+    }
+  }
+  
+public:
+  /**
+   * Constructor de la clase
+   * @param n Grado de repetición (número de veces que se repite cada bit)
+   * @param codeLayout Disposición de las copias (por defecto, bit a bit)
+   */
+  RepetitionCode(int n, Layout codeLayout = LAYOUT_BIT) : genericCoder(n) {
+    repetitionDegree = n;
+    layout = codeLayout;
+  }
+  
+  /**
+   * Método para establecer el grado de repetición
+   * @param n Nuevo grado de repetición
+   */
+  void setRepetitionDegree(int n) {
+    repetitionDegree = n;
+    genericCoder.setRepetitionDegree(n);
+  }
+  
+  /**
+   * Método para obtener el grado de repetición actual
+   * @return Grado de repetición
+   */
+  int getRepetitionDegree() {
+    return repetitionDegree;
+  }
+  
+  /**
+   * Método para establecer la disposición de las copias
+   * @param codeLayout Nueva disposición
+   */
+  void setLayout(Layout codeLayout) {
+    layout = codeLayout;
+  }
+  
+  /**
+   * Método para obtener la disposición de las copias
+   * @return Disposición actual
+   */
+  Layout getLayout() {
+    return layout;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje codificado en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud del mensaje codificado en bytes
+   */
+  int getEncodedLength(int originalLength) {
+    if (layout == LAYOUT_BLOCK) {
+      return originalLength * repetitionDegree; // n copias completas del bloque
+    }
+    return (originalLength * 8 * repetitionDegree + 7) / 8; // Redondeo hacia arriba
+  }
+  
+  /**
+   * Método para codificar un mensaje utilizando repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void encode(unsigned char *in, unsigned char *out, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      encodeBlocks(in, out, length);
+      return;
+    }
+    
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::encode(in, out, length);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::encode(in, out, length);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::encode(in, out, length);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::encode(in, out, length);
+        break;
+      default:
+        genericCoder.encode(in, out, length);
+        break;
+    }
+  }
+  
+  /**
+   * Método para decodificar un mensaje codificado con repetición
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decode(unsigned char *in, unsigned char *out, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      decodeBlocks(in, out, length);
+      return;
+    }
+    
+    RepetitionCounters *counters = localCounters();
+    
+    switch (repetitionDegree) {
+      case 3:
+        FixedRepetitionCode<3>::decode(in, out, length, counters);
+        break;
+      case 5:
+        FixedRepetitionCode<5>::decode(in, out, length, counters);
+        break;
+      case 7:
+        FixedRepetitionCode<7>::decode(in, out, length, counters);
+        break;
+      case 9:
+        FixedRepetitionCode<9>::decode(in, out, length, counters);
+        break;
+      default:
+        GenericRepetitionCode::decodeBits(in, out, length, repetitionDegree, counters);
+        break;
+    }
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método para obtener los contadores de todas las votaciones de decode desde la última
+   * llamada a resetStats (sumando los de todos los hilos)
+   * @return Votaciones unánimes y divididas
+   */
+  RepetitionCounters getStats() {
+    return stats.read();
+  }
+  
+  /**
+   * Método para poner a 0 los contadores
+   */
+  void resetStats() {
+    stats.reset();
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal a partir de las votaciones
+   * @return Estimación de f
+   */
+  float estimateChannelErrorRate() {
+    return stats.read().estimateErrorRate(repetitionDegree);
+  }
+#endif
+  
+  /**
+   * Método para decodificar un mensaje y obtener además la fiabilidad de cada bit
+   * decodificado: el margen de la votación (copias a 0 menos copias a 1), con el mismo
+   * convenio de signo que un LLR. Permite que una etapa posterior decodifique teniendo
+   * en cuenta qué bits son más dudosos.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param reliability Fiabilidad de cada bit decodificado (un int8_t por bit)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decodeSoft(unsigned char *in, unsigned char *out, int8_t *reliability, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      GenericRepetitionCode::decodeSoftBlocks(in, out, reliability, length, repetitionDegree);
+    } else {
+      GenericRepetitionCode::decodeSoftBits(in, out, reliability, length, repetitionDegree);
+    }
+  }
+  
+  /**
+   * Método para decodificar un mensaje recibido por un canal de borrado.
+   * La votación solo tiene en cuenta las copias que no se han borrado.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de bits que no se han podido recuperar
+   */
+  int decodeErasures(unsigned char *in, unsigned char *erasures, unsigned char *out, int length) {
+    if (layout == LAYOUT_BLOCK) {
+      return GenericRepetitionCode::decodeErasuresBlocks(in, erasures, out, length, repetitionDegree);
+    }
+    return genericCoder.decodeErasures(in, erasures, out, length);
+  }
+  
   /**
    * Método para mostrar información sobre un mensaje y su versión codificada
    * @param original Mensaje original
@@ -256,6 +1323,89 @@ void setup() {
     Serial.print(" ");
   }
   Serial.println();
+  
+  // Ejemplo de decodificación con borrados: se borran 4 de las 5 copias del primer bit
+  // y 3 copias del segundo, y aun así ambos se recuperan con la copia restante
+  Serial.println("\nDecodificación con borrados (R5):");
+  unsigned char erasures[codedLength];
+  for (int i = 0; i < codedLength; i++) {
+    erasures[i] = 0;
+  }
+  erasures[0] = 0b11110111;
+  coded2[0] &= ~erasures[0];
+  
+  Serial.println("Mapa de borrados:");
+  for (int j = 7; j >= 0; j--) {
+    Serial.print((erasures[0] >> j) & 1);
+  }
+  Serial.println(" ...");
+  
+  int lostBits = repCode.decodeErasures(coded2, erasures, decoded, codedLength);
+  
+  Serial.println("Mensaje decodificado:");
+  for (int i = 0; i < originalLength; i++) {
+    for (int j = 7; j >= 0; j--) {
+      Serial.print((decoded[i] >> j) & 1);
+    }
+    Serial.print(" ");
+  }
+  Serial.println();
+  Serial.print("Bits no recuperables: ");
+  Serial.println(lostBits);
+  
+  // Ejemplo de una ráfaga de 3 errores seguidos con las dos disposiciones (R3): bit a bit
+  // la ráfaga alcanza todas las copias del primer bit, por bloques solo una de cada bit
+  Serial.println("\nRáfaga de 3 errores con R3:");
+  RepetitionCode bitCode(3, RepetitionCode::LAYOUT_BIT);
+  RepetitionCode blockCode(3, RepetitionCode::LAYOUT_BLOCK);
+  RepetitionCode *burstCodes[2] = {&bitCode, &blockCode};
+  const char *layoutNames[2] = {"bit a bit", "por bloques"};
+  
+  for (int c = 0; c < 2; c++) {
+    codedLength = burstCodes[c]->getEncodedLength(originalLength);
+    unsigned char burstCoded[codedLength];
+    burstCodes[c]->encode(original, burstCoded, originalLength);
+    burstCoded[0] ^= 0b11100000; // Ráfaga en los 3 primeros bits
+    burstCodes[c]->decode(burstCoded, decoded, codedLength);
+    
+    Serial.print("Disposición ");
+    Serial.print(layoutNames[c]);
+    Serial.print(": ");
+    for (int i = 0; i < originalLength; i++) {
+      for (int j = 7; j >= 0; j--) {
+        Serial.print((decoded[i] >> j) & 1);
+      }
+      Serial.print(" ");
+    }
+    Serial.println();
+  }
+  
+  // Ejemplo de decodificación con fiabilidad (R5): se cambian 2 copias del primer bit y
+  // 1 del segundo, y el margen de la votación refleja lo dudosa que ha sido cada mayoría
+  Serial.println("\nDecodificación con fiabilidad (R5):");
+  repCode.setRepetitionDegree(5);
+  codedLength = repCode.getEncodedLength(originalLength);
+  unsigned char softCoded[codedLength];
+  repCode.encode(original, softCoded, originalLength);
+  softCoded[0] ^= 0b11000100;
+  
+  int8_t reliability[originalLength * 8];
+  repCode.decodeSoft(softCoded, decoded, reliability, codedLength);
+  
+  Serial.println("Mensaje decodificado:");
+  for (int i = 0; i < originalLength; i++) {
+    for (int j = 7; j >= 0; j--) {
+      Serial.print((decoded[i] >> j) & 1);
+    }
+    Serial.print(" ");
+  }
+  Serial.println();
+  Serial.println("Fiabilidad de cada bit:");
+  for (int i = 0; i < originalLength * 8; i++) {
+    Serial.print(reliability[i]);
+    Serial.print(" ");
+  }
+  Serial.println();
 }
 
 void loop() {
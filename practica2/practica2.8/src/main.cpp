@@ -5,6 +5,8 @@
  * la funcionalidad de codificación y decodificación Hamming en una clase reutilizable.
  * Permite codificar bloques de 4 bits en palabras código de 7 bits y decodificarlos
  * con capacidad de corrección de errores de un solo bit.
+ * Incluye también la plantilla GeneralHammingCode<R> para el resto de la familia
+ * Hamming: (15,11), (31,26) y (63,57).
  */
 #include <Arduino.h>
 
@@ -20,18 +22,533 @@ void printBinaryVector(unsigned char *vec, int length) {
   Serial.println();
 }
 
+#ifndef DECODER_STATS
+#define DECODER_STATS 0 // Con -DDECODER_STATS=1 los decodificadores llevan contadores internos
+#endif
+
+#if DECODER_STATS
+#include <atomic>
+
+/**
+ * Contadores de un decodificador con una copia por hilo. Cada hilo incrementa solo su
+ * ranura, alineada a una línea de caché para que dos hilos no escriban en la misma línea,
+ * así que el decodificador no necesita operaciones atómicas; al leer se suman todas las
+ * ranuras. Counters tiene que ser un struct de enteros con un método merge.
+ * Pueden decodificar a la vez como máximo MAX_THREADS hilos.
+ */
+template <class Counters>
+class DecoderStats {
+public:
+  static const int MAX_THREADS = 8; // Número de ranuras
+  static const int CACHE_LINE = 64; // Tamaño de una línea de caché en bytes
+  
+private:
+  // Contadores de un hilo, en sus propias líneas de caché
+  struct alignas(CACHE_LINE) Slot {
+    Counters counters;
+  };
+  
+  Slot slots[MAX_THREADS];
+  
+  /**
+   * Método auxiliar que asigna una ranura a cada hilo la primera vez que la pide
+   * @return Índice de la ranura del hilo actual
+   */
+  static int threadSlot() {
+    static std::atomic<int> nextSlot(0);
+    static thread_local int slot = nextSlot.fetch_add(1) % MAX_THREADS;
+    return slot;
+  }
+  
+public:
+  /**
+   * Constructor de la clase: todos los contadores empiezan a 0
+   */
+  DecoderStats() : slots() {
+  }
+  
+  /**
+   * Método para obtener los contadores del hilo actual
+   * @return Contadores de la ranura del hilo
+   */
+  Counters &local() {
+    return slots[threadSlot()].counters;
+  }
+  
+  /**
+   * Método para obtener la suma de los contadores de todos los hilos
+   * @return Contadores acumulados
+   */
+  Counters read() const {
+    Counters total = Counters();
+    for (int i = 0; i < MAX_THREADS; i++) {
+      total.merge(slots[i].counters);
+    }
+    return total;
+  }
+  
+  /**
+   * Método para poner a 0 todos los contadores
+   */
+  void reset() {
+    for (int i = 0; i < MAX_THREADS; i++) {
+      slots[i] = Slot();
+    }
+  }
+};
+#endif
+
+/**
+ * Contadores del decodificador Hamming (ver DECODER_STATS): un histograma de las palabras
+ * código decodificadas. Los 3 bits bajos del índice son el síndrome de la parte (7,4) y el
+ * bit 3 indica que se ha corregido un error: en (7,4) siempre que el síndrome no es nulo;
+ * en SECDED cuando falla la paridad global. Así, los índices 1 a 7 son las palabras con
+ * dos errores detectados en modo SECDED.
+ */
+struct HammingCounters {
+  uint32_t syndromes[16]; // Palabras código decodificadas por índice
+  
+  /**
+   * Método para acumular los contadores de otro hilo
+   * @param other Contadores a sumar
+   */
+  void merge(const HammingCounters &other) {
+    for (int i = 0; i < 16; i++) {
+      syndromes[i] += other.syndromes[i];
+    }
+  }
+  
+  /**
+   * Método para obtener el número de palabras código decodificadas
+   * @return Número de palabras código
+   */
+  uint32_t getCodewords() const {
+    uint32_t total = 0;
+    for (int i = 0; i < 16; i++) {
+      total += syndromes[i];
+    }
+    return total;
+  }
+  
+  /**
+   * Método para obtener el número de errores corregidos
+   * @return Palabras código en las que se ha corregido un bit
+   */
+  uint32_t getCorrections() const {
+    uint32_t total = 0;
+    for (int i = 8; i < 16; i++) {
+      total += syndromes[i];
+    }
+    return total;
+  }
+  
+  /**
+   * Método para obtener el número de palabras con dos errores detectados (solo SECDED)
+   * @return Palabras código no corregibles
+   */
+  uint32_t getUncorrectable() const {
+    return getCodewords() - getCorrections() - syndromes[0];
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal. Una palabra llega sin errores
+   * detectables con probabilidad (1 - f)^n, así que f = 1 - (limpias / total)^(1/n).
+   * @param wordBits Bits de cada palabra código (7 en (7,4), 8 en SECDED)
+   * @return Estimación de f (0 si no hay palabras)
+   */
+  float estimateErrorRate(int wordBits) const {
+    uint32_t codewords = getCodewords();
+    if (codewords == 0) {
+      return 0;
+    }
+    return 1 - powf((float)syndromes[0] / codewords, 1.0f / wordBits);
+  }
+};
+
 /**
  * Clase que implementa un codificador y decodificador Hamming (7,4).
  * Permite codificar mensajes usando el código Hamming (7,4) y decodificarlos
  * con capacidad de corrección de errores de un solo bit.
+ *
+ * Tiene dos modos:
+ * - MODE_7_4: Hamming (7,4); las palabras de 7 bits se empaquetan seguidas.
+ * - MODE_SECDED_8_4: Hamming extendido (8,4) con un bit de paridad global por palabra.
+ *   Cada palabra ocupa exactamente un byte, corrige un error y detecta dos (SECDED).
  */
 class HammingCode {
+public:
+  // Variante del código
+  enum Mode {
+    MODE_7_4,       // Hamming (7,4)
+    MODE_SECDED_8_4 // Hamming extendido (8,4): corrige un error y detecta dos
+  };
+  
+  // Bit que marca en SECDED_DECODE_TABLE las palabras con dos errores (no corregibles)
+  static const unsigned char UNCORRECTABLE = 0x10;
+  
+private:
+  Mode mode; // Variante del código
+#if DECODER_STATS
+  DecoderStats<HammingCounters> stats; // Histograma de síndromes, uno por hilo
+#endif
+  
+  // Palabra con la que trabaja el decodificador por bit slicing. En el ordenador, si hay
+  // AVX2, es un vector de 4 palabras de 64 bits (256 palabras código por paso); en el
+  // ESP32 es una palabra de 64 bits (64 palabras código por paso)
+#if defined(__AVX2__)
+  typedef uint64_t SliceWord __attribute__((vector_size(32)));
+#else
+  typedef uint64_t SliceWord;
+#endif
+  static const int SLICE_LANES = sizeof(SliceWord) / sizeof(uint64_t);
+  static const int SLICE_CODEWORDS = 64 * SLICE_LANES;
+  
+  // Palabra código de 7 bits de cada nibble (p1 en el bit 6, d4 en el bit 0)
+  static constexpr unsigned char ENCODE_TABLE[16] = {
+    0x00, 0x69, 0x2A, 0x43, 0x4C, 0x25, 0x66, 0x0F, 0x70, 0x19, 0x5A, 0x33, 0x3C, 0x55, 0x16, 0x7F
+  };
+  
+  // Nibble corregido de cada palabra de 7 bits recibida: se calcula el síndrome, se invierte
+  // el bit que indica y se extraen d1, d2, d3 y d4
+  static constexpr unsigned char DECODE_TABLE[128] = {
+    0x0, 0x0, 0x0, 0x3, 0x0, 0x5, 0xE, 0x7, 0x0, 0x9, 0x2, 0x7, 0x4, 0x7, 0x7, 0x7,
+    0x0, 0x9, 0xE, 0xB, 0xE, 0xD, 0xE, 0xE, 0x9, 0x9, 0xA, 0x9, 0xC, 0x9, 0xE, 0x7,
+    0x0, 0x5, 0x2, 0xB, 0x5, 0x5, 0x6, 0x5, 0x2, 0x1, 0x2, 0x2, 0xC, 0x5, 0x2, 0x7,
+    0x8, 0xB, 0xB, 0xB, 0xC, 0x5, 0xE, 0xB, 0xC, 0x9, 0x2, 0xB, 0xC, 0xC, 0xC, 0xF,
+    0x0, 0x3, 0x3, 0x3, 0x4, 0xD, 0x6, 0x3, 0x4, 0x1, 0xA, 0x3, 0x4, 0x4, 0x4, 0x7,
+    0x8, 0xD, 0xA, 0x3, 0xD, 0xD, 0xE, 0xD, 0xA, 0x9, 0xA, 0xA, 0x4, 0xD, 0xA, 0xF,
+    0x8, 0x1, 0x6, 0x3, 0x6, 0x5, 0x6, 0x6, 0x1, 0x1, 0x2, 0x1, 0x4, 0x1, 0x6, 0xF,
+    0x8, 0x8, 0x8, 0xB, 0x8, 0xD, 0x6, 0xF, 0x8, 0x1, 0xA, 0xF, 0xC, 0xF, 0xF, 0xF
+  };
+  
+  // Palabra código de 8 bits del modo SECDED de cada nibble: la palabra de Hamming (7,4)
+  // en los bits 7 a 1 y el bit de paridad global p0 en el bit 0
+  static constexpr unsigned char SECDED_ENCODE_TABLE[16] = {
+    0x00, 0xD2, 0x55, 0x87, 0x99, 0x4B, 0xCC, 0x1E, 0xE1, 0x33, 0xB4, 0x66, 0x78, 0xAA, 0x2D, 0xFF
+  };
+  
+  // Nibble decodificado de cada palabra de 8 bits recibida en modo SECDED. Si la paridad
+  // global falla hay un único error y se corrige con el síndrome; si la paridad es correcta
+  // pero el síndrome no es nulo hay dos errores, no se corrige nada y se activa el bit
+  // UNCORRECTABLE
+  static constexpr unsigned char SECDED_DECODE_TABLE[256] = {
+    0x00, 0x00, 0x00, 0x11, 0x00, 0x12, 0x13, 0x03, 0x00, 0x14, 0x15, 0x05, 0x16, 0x0E, 0x07, 0x17,
+    0x00, 0x10, 0x11, 0x09, 0x12, 0x02, 0x07, 0x13, 0x14, 0x04, 0x07, 0x15, 0x07, 0x16, 0x07, 0x07,
+    0x00, 0x18, 0x19, 0x09, 0x1A, 0x0E, 0x0B, 0x1B, 0x1C, 0x0E, 0x0D, 0x1D, 0x0E, 0x0E, 0x1F, 0x0E,
+    0x18, 0x09, 0x09, 0x09, 0x0A, 0x1A, 0x1B, 0x09, 0x0C, 0x1C, 0x1D, 0x09, 0x1E, 0x0E, 0x07, 0x1F,
+    0x00, 0x10, 0x11, 0x05, 0x12, 0x02, 0x0B, 0x13, 0x14, 0x05, 0x05, 0x05, 0x06, 0x16, 0x17, 0x05,
+    0x10, 0x02, 0x01, 0x11, 0x02, 0x02, 0x13, 0x02, 0x0C, 0x14, 0x15, 0x05, 0x16, 0x02, 0x07, 0x17,
+    0x18, 0x08, 0x0B, 0x19, 0x0B, 0x1A, 0x0B, 0x0B, 0x0C, 0x1C, 0x1D, 0x05, 0x1E, 0x0E, 0x0B, 0x1F,
+    0x0C, 0x18, 0x19, 0x09, 0x1A, 0x02, 0x0B, 0x1B, 0x0C, 0x0C, 0x0C, 0x1D, 0x0C, 0x1E, 0x1F, 0x0F,
+    0x00, 0x10, 0x11, 0x03, 0x12, 0x03, 0x03, 0x03, 0x14, 0x04, 0x0D, 0x15, 0x06, 0x16, 0x17, 0x03,
+    0x10, 0x04, 0x01, 0x11, 0x0A, 0x12, 0x13, 0x03, 0x04, 0x04, 0x15, 0x04, 0x16, 0x04, 0x07, 0x17,
+    0x18, 0x08, 0x0D, 0x19, 0x0A, 0x1A, 0x1B, 0x03, 0x0D, 0x1C, 0x0D, 0x0D, 0x1E, 0x0E, 0x0D, 0x1F,
+    0x0A, 0x18, 0x19, 0x09, 0x0A, 0x0A, 0x0A, 0x1B, 0x1C, 0x04, 0x0D, 0x1D, 0x0A, 0x1E, 0x1F, 0x0F,
+    0x10, 0x08, 0x01, 0x11, 0x06, 0x12, 0x13, 0x03, 0x06, 0x14, 0x15, 0x05, 0x06, 0x06, 0x06, 0x17,
+    0x01, 0x10, 0x01, 0x01, 0x12, 0x02, 0x01, 0x13, 0x14, 0x04, 0x01, 0x15, 0x06, 0x16, 0x17, 0x0F,
+    0x08, 0x08, 0x19, 0x08, 0x1A, 0x08, 0x0B, 0x1B, 0x1C, 0x08, 0x0D, 0x1D, 0x06, 0x1E, 0x1F, 0x0F,
+    0x18, 0x08, 0x01, 0x19, 0x0A, 0x1A, 0x1B, 0x0F, 0x0C, 0x1C, 0x1D, 0x0F, 0x1E, 0x0F, 0x0F, 0x0F
+  };
+  
+  /**
+   * Método auxiliar que calcula el síndrome de una palabra código de 7 bits
+   * @param word Palabra código con p1 en el bit 6 y d4 en el bit 0 (p1, p2, d1, p3, d2, d3, d4)
+   * @return Posición del error (1 a 7) o 0 si la palabra es válida
+   */
+  static unsigned char codewordSyndrome(unsigned char word) {
+    unsigned char s1 = ((word >> 6) ^ (word >> 4) ^ (word >> 2) ^ word) & 1; // p1 ^ d1 ^ d2 ^ d4
+    unsigned char s2 = ((word >> 5) ^ (word >> 4) ^ (word >> 1) ^ word) & 1; // p2 ^ d1 ^ d3 ^ d4
+    unsigned char s3 = ((word >> 3) ^ (word >> 2) ^ (word >> 1) ^ word) & 1; // p3 ^ d2 ^ d3 ^ d4
+    return (s3 << 2) | (s2 << 1) | s1;
+  }
+  
+  /**
+   * Método auxiliar que comprueba si una palabra es una palabra código del modo actual
+   * @param word Palabra de 7 bits (modo (7,4)) u 8 bits (modo SECDED, p0 en el bit 0)
+   * @return true si la palabra es una palabra código válida
+   */
+  bool isCodeword(unsigned char word) {
+    if (mode == MODE_SECDED_8_4) {
+      return codewordSyndrome(word >> 1) == 0 && (__builtin_popcount(word) % 2) == 0;
+    }
+    return codewordSyndrome(word) == 0;
+  }
+  
+  /**
+   * Método auxiliar que devuelve los contadores del hilo actual
+   * @return Contadores del hilo, o NULL si DECODER_STATS está a 0
+   */
+  HammingCounters *localCounters() {
+#if DECODER_STATS
+    return &stats.local();
+#else
+    return NULL;
+#endif
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método auxiliar que añade una palabra de 7 bits decodificada al histograma
+   * @param counters Contadores a actualizar
+   * @param word Palabra recibida (p1 en el bit 6)
+   */
+  static void countCodeword(HammingCounters *counters, unsigned char word) {
+    unsigned char syndrome = codewordSyndrome(word);
+    counters->syndromes[syndrome == 0 ? 0 : (syndrome | 8)]++;
+  }
+  
+  /**
+   * Método auxiliar que añade una palabra SECDED decodificada al histograma
+   * @param counters Contadores a actualizar
+   * @param word Palabra recibida de 8 bits (p0 en el bit 0)
+   */
+  static void countSecdedCodeword(HammingCounters *counters, unsigned char word) {
+    unsigned char parityFails = __builtin_popcount(word) & 1;
+    counters->syndromes[codewordSyndrome(word >> 1) | (parityFails << 3)]++;
+  }
+#endif
+  
+  /**
+   * Método auxiliar que traspone matrices de 8 x 8 bits, una por cada palabra de 64 bits.
+   * La fila r es el byte r contando desde el más significativo y la columna c es el bit
+   * 7 - c de cada byte.
+   * @param x Matrices de 8 x 8 bits
+   * @return Matrices traspuestas
+   */
+  static SliceWord transposeBits(SliceWord x) {
+    SliceWord t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+  }
+  
+  /**
+   * Método auxiliar que traspone matrices de 8 x 8 bytes: el byte j de words[g] pasa a
+   * ser el byte g de words[j] (bytes contados desde el más significativo)
+   * @param words Filas de las matrices
+   */
+  static void transposeBytes(SliceWord *words) {
+    // Intercambiar bloques de 32, 16 y 8 bits entre filas a distancia 4, 2 y 1
+    for (int i = 0; i < 4; i++) {
+      swapBlocks(words[i], words[i + 4], 32, 0xFFFFFFFF00000000ULL);
+    }
+    for (int i = 0; i < 2; i++) {
+      swapBlocks(words[i], words[i + 2], 16, 0xFFFF0000FFFF0000ULL);
+      swapBlocks(words[i + 4], words[i + 6], 16, 0xFFFF0000FFFF0000ULL);
+    }
+    for (int i = 0; i < 8; i += 2) {
+      swapBlocks(words[i], words[i + 1], 8, 0xFF00FF00FF00FF00ULL);
+    }
+  }
+  
+  /**
+   * Método auxiliar que intercambia bloques de bits entre dos filas: los bloques bajos de
+   * high pasan a ser los altos de low y viceversa
+   * @param high Fila superior
+   * @param low Fila inferior
+   * @param shift Tamaño de los bloques en bits
+   * @param mask Máscara de los bloques altos
+   */
+  static void swapBlocks(SliceWord &high, SliceWord &low, int shift, uint64_t mask) {
+    SliceWord newHigh = (high & mask) | ((low >> shift) & ~mask);
+    SliceWord newLow = ((high << shift) & mask) | (low & ~mask);
+    high = newHigh;
+    low = newLow;
+  }
+  
+  /**
+   * Método auxiliar que separa 8 palabras código de 7 bits seguidas (56 bits menos
+   * significativos) en 8 bytes, con cada palabra alineada a la izquierda de su byte
+   * @param packed Palabras código empaquetadas
+   * @return Palabra i en el byte i contando desde el más significativo
+   */
+  static SliceWord spreadCodewords(SliceWord packed) {
+    // La palabra k (contando desde la menos significativa) se desplaza k bits en tres pasos
+    packed = ((packed & 0x00FFFFFFF0000000ULL) << 4) | (packed & 0x000000000FFFFFFFULL);
+    packed = ((packed & 0x0FFFC0000FFFC000ULL) << 2) | (packed & ~0x0FFFC0000FFFC000ULL);
+    packed = ((packed & 0x3F803F803F803F80ULL) << 1) | (packed & ~0x3F803F803F803F80ULL);
+    return packed << 1;
+  }
+  
+  /**
+   * Método auxiliar que decodifica SLICE_CODEWORDS palabras código con bit slicing. Las
+   * palabras se trasponen a 7 planos de bits (planes[j] contiene el bit j de todas ellas),
+   * el síndrome y la corrección se calculan a la vez para todas con operaciones lógicas,
+   * y los 4 planos de datos se vuelven a trasponer. Cada palabra de 64 bits de SliceWord
+   * lleva un bloque independiente de 64 palabras código (56 bytes de entrada).
+   * @param in Vector de entrada (SLICE_LANES bloques de 56 bytes)
+   * @param out Vector de salida (SLICE_LANES bloques de 32 bytes)
+   * @param counters Contadores del histograma (NULL o DECODER_STATS a 0 para no contar)
+   */
+  static void decodeSlicedBlock(unsigned char *in, unsigned char *out, HammingCounters *counters) {
+    // Leer cada bloque como 7 palabras de 64 bits (la octava queda a 0)
+    SliceWord stream[8];
+    memset(stream, 0, sizeof(stream));
+    for (int k = 0; k < 7; k++) {
+      uint64_t lanes[SLICE_LANES];
+      for (int lane = 0; lane < SLICE_LANES; lane++) {
+        memcpy(&lanes[lane], in + 56 * lane + 8 * k, 8);
+        lanes[lane] = __builtin_bswap64(lanes[lane]); // Primer byte en la parte alta
+      }
+      memcpy(&stream[k], lanes, sizeof(SliceWord));
+    }
+    
+    // Cada grupo de 8 palabras código (56 bits) se separa en bytes y se traspone: el byte j
+    // de planes[g] pasa a contener el bit j de las 8 palabras del grupo
+    SliceWord planes[8];
+    for (int g = 0; g < 8; g++) {
+      int word = (56 * g) / 64;
+      int shift = (56 * g) % 64;
+      SliceWord packed = stream[word] << shift;
+      if (shift > 8) {
+        packed |= stream[word + 1] >> (64 - shift);
+      }
+      planes[g] = transposeBits(spreadCodewords(packed >> 8));
+    }
+    
+    // Reunir los bytes de los 8 grupos: planes[j] contiene el bit j de las 64 palabras
+    transposeBytes(planes);
+    
+    // Síndrome y corrección de las 64 palabras a la vez
+    SliceWord s1 = planes[0] ^ planes[2] ^ planes[4] ^ planes[6]; // p1 ^ d1 ^ d2 ^ d4
+    SliceWord s2 = planes[1] ^ planes[2] ^ planes[5] ^ planes[6]; // p2 ^ d1 ^ d3 ^ d4
+    SliceWord s3 = planes[3] ^ planes[4] ^ planes[5] ^ planes[6]; // p3 ^ d2 ^ d3 ^ d4
+#if DECODER_STATS
+    if (counters != NULL) {
+      // Palabras con cada síndrome no nulo; el resto tiene síndrome 0
+      uint32_t withErrors = 0;
+      for (int syndrome = 1; syndrome < 8; syndrome++) {
+        SliceWord match = ((syndrome & 1) ? s1 : ~s1) & ((syndrome & 2) ? s2 : ~s2) & ((syndrome & 4) ? s3 : ~s3);
+        uint64_t lanes[SLICE_LANES];
+        memcpy(lanes, &match, sizeof(SliceWord));
+        uint32_t count = 0;
+        for (int lane = 0; lane < SLICE_LANES; lane++) {
+          count += __builtin_popcountll(lanes[lane]);
+        }
+        counters->syndromes[syndrome | 8] += count;
+        withErrors += count;
+      }
+      counters->syndromes[0] += SLICE_CODEWORDS - withErrors;
+    }
+#else
+    (void)counters;
+#endif
+    SliceWord data[8];
+    memset(data, 0, sizeof(data));
+    data[0] = planes[2] ^ (s1 & s2 & ~s3);  // d1 (posición 3)
+    data[1] = planes[4] ^ (s1 & ~s2 & s3);  // d2 (posición 5)
+    data[2] = planes[5] ^ (~s1 & s2 & s3);  // d3 (posición 6)
+    data[3] = planes[6] ^ (s1 & s2 & s3);   // d4 (posición 7)
+    
+    // Deshacer la trasposición: cada palabra deja su nibble en los 4 bits altos de su byte
+    transposeBytes(data);
+    for (int g = 0; g < 8; g++) {
+      SliceWord nibbles = (transposeBits(data[g]) & 0xF0F0F0F0F0F0F0F0ULL) >> 4;
+      
+      // Juntar los nibbles de dos en dos: 4 bytes de salida en los 32 bits bajos
+      nibbles = (nibbles | (nibbles >> 4)) & 0x00FF00FF00FF00FFULL;
+      nibbles = (nibbles | (nibbles >> 8)) & 0x0000FFFF0000FFFFULL;
+      nibbles = (nibbles | (nibbles >> 16)) & 0x00000000FFFFFFFFULL;
+      
+      uint64_t lanes[SLICE_LANES];
+      memcpy(lanes, &nibbles, sizeof(SliceWord));
+      for (int lane = 0; lane < SLICE_LANES; lane++) {
+        uint32_t bytes = __builtin_bswap32((uint32_t)lanes[lane]); // Primer byte en la parte alta
+        memcpy(out + 32 * lane + 4 * g, &bytes, 4);
+      }
+    }
+  }
+  
+  /**
+   * Método auxiliar que decodifica con DECODE_TABLE a partir de una palabra código dada.
+   * Cada palabra de 7 bits se corrige y se convierte en su nibble con una consulta a la
+   * tabla. Las palabras se leen de una palabra de 64 bits: 7 bytes de entrada contienen
+   * exactamente 8 palabras código, que dan 4 bytes de salida.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @param firstCodeword Primera palabra código que se decodifica (múltiplo de 8)
+   */
+  void decodeWithTable(unsigned char *in, unsigned char *out, int length, int firstCodeword) {
+    int codewords = (length * 8) / 7; // Número de palabras código completas
+    int blocks = codewords / 8;       // Bloques de 7 bytes de entrada (8 palabras código)
+#if DECODER_STATS
+    HammingCounters *counters = localCounters();
+#endif
+    
+    for (int block = firstCodeword / 8; block < blocks; block++) {
+      uint64_t buffer = 0;
+      for (int k = 0; k < 7; k++) {
+        buffer = (buffer << 8) | in[block * 7 + k];
+      }
+      for (int i = 0; i < 4; i++) {
+        unsigned char high = DECODE_TABLE[(buffer >> (49 - 14 * i)) & 0x7F];
+        unsigned char low = DECODE_TABLE[(buffer >> (42 - 14 * i)) & 0x7F];
+        out[block * 4 + i] = (high << 4) | low;
+      }
+#if DECODER_STATS
+      if (counters != NULL) {
+        for (int k = 0; k < 8; k++) {
+          countCodeword(counters, (buffer >> (49 - 7 * k)) & 0x7F);
+        }
+      }
+#endif
+    }
+    
+    // Palabras código restantes: se leen de 7 en 7 bits cargando bytes según se necesitan
+    uint64_t buffer = 0;           // Bits pendientes de leer, alineados a la derecha
+    int bufferBits = 0;            // Número de bits pendientes
+    int inByteIndex = blocks * 7;  // Siguiente byte de entrada
+    int outByteIndex = blocks * 4; // Byte de salida actual
+    for (int c = blocks * 8; c < codewords; c++) {
+      if (bufferBits < 7) {
+        buffer = (buffer << 8) | in[inByteIndex++];
+        bufferBits += 8;
+      }
+      bufferBits -= 7;
+      unsigned char nibble = DECODE_TABLE[(buffer >> bufferBits) & 0x7F];
+#if DECODER_STATS
+      if (counters != NULL) {
+        countCodeword(counters, (buffer >> bufferBits) & 0x7F);
+      }
+#endif
+      
+      // Las palabras pares van a la parte alta del byte y las impares a la parte baja
+      if (c % 2 == 0) {
+        out[outByteIndex] = nibble << 4;
+      } else {
+        out[outByteIndex++] |= nibble;
+      }
+    }
+  }
+  
 public:
   /**
    * Constructor de la clase
+   * @param codeMode Variante del código (por defecto, Hamming (7,4))
    */
-  HammingCode() {
-    // No se requieren parámetros para Hamming (7,4)
+  HammingCode(Mode codeMode = MODE_7_4) {
+    mode = codeMode;
+  }
+  
+  /**
+   * Método para establecer la variante del código
+   * @param codeMode Nueva variante
+   */
+  void setMode(Mode codeMode) {
+    mode = codeMode;
+  }
+  
+  /**
+   * Método para obtener la variante del código
+   * @return Variante actual
+   */
+  Mode getMode() {
+    return mode;
   }
   
   /**
@@ -40,161 +557,268 @@ public:
    * @return Longitud del mensaje codificado en bytes
    */
   int getEncodedLength(int originalLength) {
+    if (mode == MODE_SECDED_8_4) {
+      return originalLength * 2; // Un byte por cada bloque de 4 bits
+    }
+    
     // Cada byte tiene 2 bloques de 4 bits, y cada bloque genera 7 bits
     int codedBits = originalLength * 2 * 7; // Número total de bits en la salida codificada
     return (codedBits + 7) / 8; // Redondeo hacia arriba para obtener bytes
   }
   
   /**
-   * Método para codificar un mensaje utilizando Hamming (7,4)
+   * Método para codificar un mensaje utilizando Hamming (7,4).
+   * Cada nibble se codifica con una consulta a ENCODE_TABLE y las palabras de 7 bits se
+   * acumulan en una palabra de 64 bits: 4 bytes de entrada dan exactamente 56 bits, que se
+   * escriben como 7 bytes de salida.
    * @param in Vector binario de entrada empaquetado en unsigned char
    * @param out Vector binario de salida empaquetado en unsigned char
    * @param length Longitud del vector de entrada en bytes
    */
   void encode(unsigned char *in, unsigned char *out, int length) {
-    int outBitIndex = 0; // Índice del bit actual en el vector de salida
-    
-    // Recorrer cada byte del vector de entrada
-    for (int i = 0; i < length; i++) {
-      // Procesar cada bloque de 4 bits del byte actual (primero los 4 bits más significativos)
-      for (int nibbleIndex = 0; nibbleIndex < 2; nibbleIndex++) {
-        // Extraer el bloque de 4 bits
-        unsigned char nibble;
-        if (nibbleIndex == 0) {
-          // Extraer los 4 bits más significativos (posiciones 7-4)
-          nibble = (in[i] >> 4) & 0x0F;
-        } else {
-          // Extraer los 4 bits menos significativos (posiciones 3-0)
-          nibble = in[i] & 0x0F;
-        }
-        
-        // Extraer los bits de datos individuales (d1, d2, d3, d4)
-        unsigned char d1 = (nibble >> 3) & 1; // Bit más significativo
-        unsigned char d2 = (nibble >> 2) & 1;
-        unsigned char d3 = (nibble >> 1) & 1;
-        unsigned char d4 = nibble & 1;        // Bit menos significativo
-        
-        // Calcular los bits de paridad según las ecuaciones de Hamming (7,4)
-        unsigned char p1 = d1 ^ d2 ^ d4;      // p1 = d1 + d2 + d4 (XOR)
-        unsigned char p2 = d1 ^ d3 ^ d4;      // p2 = d1 + d3 + d4 (XOR)
-        unsigned char p3 = d2 ^ d3 ^ d4;      // p3 = d2 + d3 + d4 (XOR)
-        
-        // Formar la palabra código de 7 bits: p1, p2, d1, p3, d2, d3, d4
-        unsigned char resultado[7] = {p1, p2, d1, p3, d2, d3, d4};
-        
-        // Colocar los 7 bits de la palabra código en el vector de salida
-        for (int j = 0; j < 7; j++) {
-          // Calcular el índice del byte de salida donde se colocará el bit
-          int outByteIndex = outBitIndex / 8;
-          // Calcular la posición del bit dentro del byte de salida
-          int outBitPosition = 7 - (outBitIndex % 8);
-          
-          // Si estamos en un nuevo byte, inicializarlo a 0
-          if (outBitPosition == 7) {
-            out[outByteIndex] = 0;
-          }
-          
-          // Colocar el bit en la posición correspondiente del byte de salida
-          out[outByteIndex] |= (resultado[j] << outBitPosition);
-          
-          // Incrementar el índice del bit de salida
-          outBitIndex++;
-        }
+    if (mode == MODE_SECDED_8_4) {
+      // Cada nibble da un byte de salida
+      for (int i = 0; i < length; i++) {
+        out[2 * i] = SECDED_ENCODE_TABLE[in[i] >> 4];
+        out[2 * i + 1] = SECDED_ENCODE_TABLE[in[i] & 0x0F];
+      }
+      return;
+    }
+    
+    int blocks = length / 4; // Bloques de 4 bytes de entrada (8 palabras código)
+    
+    for (int block = 0; block < blocks; block++) {
+      uint64_t buffer = 0;
+      for (int i = 0; i < 4; i++) {
+        unsigned char value = in[block * 4 + i];
+        buffer = (buffer << 14) | (ENCODE_TABLE[value >> 4] << 7) | ENCODE_TABLE[value & 0x0F];
+      }
+      for (int k = 0; k < 7; k++) {
+        out[block * 7 + k] = (unsigned char)(buffer >> (48 - 8 * k));
+      }
+    }
+    
+    // Bytes restantes: se escriben los bytes completos según se van llenando
+    uint64_t buffer = 0;             // Bits pendientes de escribir, alineados a la derecha
+    int bufferBits = 0;              // Número de bits pendientes
+    int outByteIndex = blocks * 7;   // Siguiente byte de salida
+    for (int i = blocks * 4; i < length; i++) {
+      buffer = (buffer << 14) | (ENCODE_TABLE[in[i] >> 4] << 7) | ENCODE_TABLE[in[i] & 0x0F];
+      bufferBits += 14;
+      while (bufferBits >= 8) {
+        bufferBits -= 8;
+        out[outByteIndex++] = (unsigned char)(buffer >> bufferBits);
       }
     }
+    
+    // Último byte incompleto, completado con ceros
+    if (bufferBits > 0) {
+      out[outByteIndex] = (unsigned char)(buffer << (8 - bufferBits));
+    }
   }
   
   /**
-   * Método para decodificar un mensaje codificado con Hamming (7,4)
+   * Método para decodificar un mensaje codificado con Hamming (7,4). Si hay AVX2 se usa el
+   * decodificador por bit slicing, que es el más rápido; si no, el de tabla.
    * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
    * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
    * @param length Longitud del vector de entrada en bytes
    */
   void decode(unsigned char *in, unsigned char *out, int length) {
+    if (mode == MODE_SECDED_8_4) {
+      decodeWithFlags(in, out, NULL, length);
+      return;
+    }
+    
+#if defined(__AVX2__)
+    decodeBitSliced(in, out, length);
+#else
+    decodeWithTable(in, out, length, 0);
+#endif
+  }
+  
+  /**
+   * Método para decodificar un mensaje Hamming (7,4) por bit slicing: las palabras código
+   * se procesan de SLICE_CODEWORDS en SLICE_CODEWORDS (64, o 256 con AVX2) y las que
+   * sobran al final se decodifican con la tabla. El resultado es idéntico al de decode.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  void decodeBitSliced(unsigned char *in, unsigned char *out, int length) {
+    int blocks = ((length * 8) / 7) / SLICE_CODEWORDS;
+    HammingCounters *counters = localCounters();
+    
+    for (int block = 0; block < blocks; block++) {
+      decodeSlicedBlock(in + block * SLICE_CODEWORDS * 7 / 8, out + block * SLICE_CODEWORDS / 2, counters);
+    }
+    decodeWithTable(in, out, length, blocks * SLICE_CODEWORDS);
+  }
+  
+#if DECODER_STATS
+  /**
+   * Método para obtener el histograma de síndromes de todas las palabras decodificadas
+   * con decode, decodeBitSliced y decodeWithFlags desde la última llamada a resetStats
+   * (sumando los de todos los hilos)
+   * @return Contadores acumulados
+   */
+  HammingCounters getStats() {
+    return stats.read();
+  }
+  
+  /**
+   * Método para poner a 0 los contadores
+   */
+  void resetStats() {
+    stats.reset();
+  }
+  
+  /**
+   * Método para estimar la probabilidad de error del canal a partir de los síndromes
+   * @return Estimación de f
+   */
+  float estimateChannelErrorRate() {
+    return stats.read().estimateErrorRate(mode == MODE_SECDED_8_4 ? 8 : 7);
+  }
+#endif
+  
+  /**
+   * Método para decodificar un mensaje indicando qué palabras código no se han podido
+   * corregir. En modo SECDED cada byte de entrada es una palabra código, así que basta
+   * una consulta a SECDED_DECODE_TABLE por byte; las palabras con dos errores se marcan
+   * en lugar de corregirse mal. En modo (7,4) no se pueden detectar y todas las marcas
+   * quedan a 0.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param uncorrectable Marca de cada palabra código (1 = no corregible); puede ser NULL
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de palabras código no corregibles
+   */
+  int decodeWithFlags(unsigned char *in, unsigned char *out, unsigned char *uncorrectable, int length) {
+    if (mode != MODE_SECDED_8_4) {
+      decode(in, out, length);
+      if (uncorrectable != NULL) {
+        for (int c = 0; c < (length * 8) / 7; c++) {
+          uncorrectable[c] = 0;
+        }
+      }
+      return 0;
+    }
+    
+    int failures = 0; // Palabras código no corregibles
+#if DECODER_STATS
+    HammingCounters *counters = localCounters();
+#endif
+    
+    for (int c = 0; c < length; c++) {
+      unsigned char decoded = SECDED_DECODE_TABLE[in[c]];
+#if DECODER_STATS
+      if (counters != NULL) {
+        countSecdedCodeword(counters, in[c]);
+      }
+#endif
+      unsigned char flag = (decoded & UNCORRECTABLE) ? 1 : 0;
+      failures += flag;
+      if (uncorrectable != NULL) {
+        uncorrectable[c] = flag;
+      }
+      
+      // Las palabras pares van a la parte alta del byte y las impares a la parte baja
+      if (c % 2 == 0) {
+        out[c / 2] = (decoded & 0x0F) << 4;
+      } else {
+        out[c / 2] |= decoded & 0x0F;
+      }
+    }
+    return failures;
+  }
+  
+  /**
+   * Método para decodificar un mensaje recibido por un canal de borrado.
+   * Para cada palabra código se prueban todos los valores posibles de los bits borrados y
+   * se elige el que da una palabra válida. Como la distancia mínima es 3 en (7,4) y 4 en
+   * SECDED, la solución es única con hasta dos o tres bits borrados respectivamente; con
+   * más borrados solo se recupera la palabra si sigue habiendo una única solución. Las
+   * palabras sin borrados se decodifican como en decode.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param erasures Mapa de borrados empaquetado igual que in (bit a 1 = bit borrado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   * @return Número de palabras código que no se han podido recuperar sin ambigüedad
+   */
+  int decodeErasures(unsigned char *in, unsigned char *erasures, unsigned char *out, int length) {
+    int wordBits = (mode == MODE_SECDED_8_4) ? 8 : 7; // Bits de cada palabra código
     int inBitIndex = 0;   // Índice del bit actual en el vector de entrada
     int outBitIndex = 0;  // Índice del bit actual en el vector de salida
+    int failures = 0;     // Palabras código no recuperadas
     
-    // Inicializar el vector de salida a ceros
-    int outBytes = (length * 8 * 4) / 7; // Aproximación del número de bytes necesarios
-    outBytes = (outBytes + 7) / 8;  // Redondeo hacia arriba
+    // Número exacto de palabras código completas y de bytes de salida
+    int codewords = (length * 8) / wordBits;
+    int outBytes = (codewords * 4 + 7) / 8;
     
     for (int i = 0; i < outBytes; i++) {
       out[i] = 0;
     }
     
-    // Procesar cada palabra código de 7 bits
-    while (inBitIndex + 6 < length * 8) { // Asegurarse de que hay al menos 7 bits disponibles
-      // Extraer los 7 bits de la palabra código
-      unsigned char codeword[7];
-      
-      for (int j = 0; j < 7; j++) {
-        // Calcular el índice del byte de entrada y la posición del bit
+    for (int c = 0; c < codewords; c++) {
+      // Leer la palabra código y su máscara de borrados (p1 en el bit más significativo)
+      unsigned char word = 0;
+      unsigned char erased = 0;
+      for (int j = 0; j < wordBits; j++) {
         int inByteIndex = inBitIndex / 8;
         int inBitPosition = 7 - (inBitIndex % 8);
-        
-        // Extraer el bit de la posición correspondiente
-        codeword[j] = (in[inByteIndex] >> inBitPosition) & 1;
-        
-        // Avanzar al siguiente bit de entrada
+        word = (word << 1) | ((in[inByteIndex] >> inBitPosition) & 1);
+        erased = (erased << 1) | ((erasures[inByteIndex] >> inBitPosition) & 1);
         inBitIndex++;
       }
       
-      // Extraer bits de paridad y datos de la palabra código
-      unsigned char p1 = codeword[0]; // Bit de paridad 1
-      unsigned char p2 = codeword[1]; // Bit de paridad 2
-      unsigned char d1 = codeword[2]; // Bit de dato 1
-      unsigned char p3 = codeword[3]; // Bit de paridad 3
-      unsigned char d2 = codeword[4]; // Bit de dato 2
-      unsigned char d3 = codeword[5]; // Bit de dato 3
-      unsigned char d4 = codeword[6]; // Bit de dato 4
-      
-      // Calcular el síndrome para detectar errores
-      unsigned char s1 = p1 ^ d1 ^ d2 ^ d4; // Verificar paridad 1
-      unsigned char s2 = p2 ^ d1 ^ d3 ^ d4; // Verificar paridad 2
-      unsigned char s3 = p3 ^ d2 ^ d3 ^ d4; // Verificar paridad 3
-      
-      // Determinar la posición del error (si existe)
-      unsigned char errorPos = (s3 << 2) | (s2 << 1) | s1;
-      
-      // Corregir el error si se detecta (errorPos != 0)
-      if (errorPos != 0) {
-        // Posiciones de error y su correspondencia en el array codeword
-        // 1 -> p1 (índice 0)
-        // 2 -> p2 (índice 1)
-        // 3 -> d1 (índice 2)
-        // 4 -> p3 (índice 3)
-        // 5 -> d2 (índice 4)
-        // 6 -> d3 (índice 5)
-        // 7 -> d4 (índice 6)
+      unsigned char nibble;
+      if (erased == 0) {
+        // Sin borrados: decodificar con las tablas
+        if (mode == MODE_SECDED_8_4) {
+          nibble = SECDED_DECODE_TABLE[word];
+          if (nibble & UNCORRECTABLE) {
+            failures++;
+          }
+          nibble &= 0x0F;
+        } else {
+          nibble = DECODE_TABLE[word];
+        }
+      } else {
+        // Probar todas las combinaciones de los bits borrados
+        int solutions = 0;
+        unsigned char solution = word & ~erased;
+        unsigned char fill = erased;
+        while (true) {
+          unsigned char candidate = (word & ~erased) | fill;
+          if (isCodeword(candidate)) {
+            solutions++;
+            solution = candidate;
+          }
+          if (fill == 0) {
+            break;
+          }
+          fill = (fill - 1) & erased;
+        }
+        if (solutions != 1) {
+          failures++;
+        }
         
-        // Corregir el bit erróneo
-        if (errorPos >= 1 && errorPos <= 7) {
-          // Invertir el bit en la posición del error
-          codeword[errorPos - 1] = codeword[errorPos - 1] ^ 1;
-          
-          // Actualizar los bits de datos si fueron corregidos
-          if (errorPos == 3) d1 = codeword[2];
-          else if (errorPos == 5) d2 = codeword[4];
-          else if (errorPos == 6) d3 = codeword[5];
-          else if (errorPos == 7) d4 = codeword[6];
+        // Quitar la paridad global y extraer los bits de datos d1, d2, d3, d4
+        if (mode == MODE_SECDED_8_4) {
+          solution >>= 1;
         }
+        nibble = (((solution >> 4) & 1) << 3) | (((solution >> 2) & 1) << 2) | (solution & 0x03);
       }
       
-      // Reconstruir el nibble (4 bits) original
-      unsigned char nibble = (d1 << 3) | (d2 << 2) | (d3 << 1) | d4;
-      
-      // Determinar si este nibble va en la parte alta o baja del byte de salida
       if (outBitIndex % 8 == 0) {
-        // Parte alta del byte (bits 7-4)
         out[outBitIndex / 8] |= (nibble << 4);
       } else {
-        // Parte baja del byte (bits 3-0)
         out[outBitIndex / 8] |= nibble;
       }
-      
-      // Avanzar 4 bits en el índice de salida (un nibble)
       outBitIndex += 4;
     }
+    return failures;
   }
   
   /**
@@ -208,7 +832,7 @@ public:
     Serial.println("Mensaje original:");
     ::printBinaryVector(original, originalLength);
     
-    Serial.println("Mensaje codificado con Hamming (7,4):");
+    Serial.println(mode == MODE_SECDED_8_4 ? "Mensaje codificado con Hamming extendido (8,4):" : "Mensaje codificado con Hamming (7,4):");
     ::printBinaryVector(coded, codedLength);
     
     Serial.print("Bits del mensaje original: ");
@@ -216,7 +840,253 @@ public:
     Serial.print("Bits del mensaje codificado: ");
     Serial.println(codedLength * 8);
     Serial.print("Tasa de código: ");
-    Serial.println("4/7");
+    Serial.println(mode == MODE_SECDED_8_4 ? "4/8" : "4/7");
+  }
+};
+
+/**
+ * Clase que implementa la familia de códigos Hamming (2^R - 1, 2^R - 1 - R): (7,4) con R = 3,
+ * (15,11) con R = 4, (31,26) con R = 5 y (63,57) con R = 6. Cuanto mayor es R, mayor es la
+ * tasa del código (más datos por cada bit de paridad), pero solo se corrige un error por
+ * palabra código.
+ *
+ * Las palabras usan la numeración clásica: las posiciones 1, 2, 4, 8... son bits de paridad
+ * y el resto son datos, y la posición 1 se transmite la primera. Con R = 3 el resultado es
+ * el mismo que el de HammingCode. El mensaje se trata como una secuencia de bits que se
+ * parte en bloques de K bits; el último bloque se completa con ceros.
+ *
+ * Cada palabra código se guarda en un uint64_t. Las paridades y el síndrome se calculan con
+ * popcount sobre la palabra enmascarada, así que el coste crece con el número de palabras
+ * código y no con el número de bits.
+ */
+template <int R>
+class GeneralHammingCode {
+public:
+  static const int N = (1 << R) - 1; // Bits de cada palabra código
+  static const int K = N - R;        // Bits de datos de cada palabra código
+  
+private:
+  static_assert(R >= 2 && R <= 6, "La palabra código tiene que caber en 64 bits");
+  
+  // Máscaras generadas en tiempo de compilación. En las palabras código la posición p está
+  // en el bit N - p; en los datos, el primer bit está en el bit K - 1.
+  struct Tables {
+    uint64_t parityMasks[R];    // Bits de datos que entran en cada bit de paridad
+    uint64_t syndromeMasks[R];  // Posiciones que comprueba cada bit del síndrome (matriz H)
+    uint64_t errorMasks[N + 1]; // Bit que hay que invertir para cada síndrome (0 = ninguno)
+    
+    constexpr Tables() : parityMasks(), syndromeMasks(), errorMasks() {
+      int dataIndex = 0;
+      for (int position = 1; position <= N; position++) {
+        bool isParity = (position & (position - 1)) == 0;
+        for (int i = 0; i < R; i++) {
+          if ((position >> i) & 1) {
+            syndromeMasks[i] |= (uint64_t)1 << (N - position);
+            if (!isParity) {
+              parityMasks[i] |= (uint64_t)1 << (K - 1 - dataIndex);
+            }
+          }
+        }
+        if (!isParity) {
+          dataIndex++;
+        }
+        errorMasks[position] = (uint64_t)1 << (N - position);
+      }
+    }
+  };
+  
+  static constexpr Tables TABLES = Tables();
+  
+  // Lector de bits de un vector empaquetado (el primer bit es el más significativo)
+  struct BitReader {
+    unsigned char *data; // Vector de entrada
+    int length;          // Longitud del vector en bytes
+    int byteIndex;       // Siguiente byte por cargar
+    uint64_t buffer;     // Bits cargados y pendientes de leer, alineados a la derecha
+    int bufferBits;      // Número de bits pendientes
+    
+    BitReader(unsigned char *in, int inLength) : data(in), length(inLength), byteIndex(0), buffer(0), bufferBits(0) {
+    }
+    
+    /**
+     * Método para leer los siguientes bits (a partir del final del vector se leen ceros)
+     * @param count Número de bits (como máximo 32)
+     * @return Bits leídos, alineados a la derecha
+     */
+    uint64_t read(int count) {
+      while (bufferBits < count) {
+        buffer = (buffer << 8) | (byteIndex < length ? data[byteIndex] : 0);
+        byteIndex++;
+        bufferBits += 8;
+      }
+      bufferBits -= count;
+      return (buffer >> bufferBits) & (((uint64_t)1 << count) - 1);
+    }
+    
+    /**
+     * Método para leer una palabra de hasta 64 bits en dos partes
+     * @param count Número de bits
+     * @return Bits leídos, alineados a la derecha
+     */
+    uint64_t readWord(int count) {
+      if (count <= 32) {
+        return read(count);
+      }
+      uint64_t high = read(count - 32);
+      return (high << 32) | read(32);
+    }
+  };
+  
+  // Escritor de bits en un vector empaquetado (el primer bit es el más significativo)
+  struct BitWriter {
+    unsigned char *data; // Vector de salida
+    int byteIndex;       // Siguiente byte por escribir
+    uint64_t buffer;     // Bits pendientes de escribir, alineados a la derecha
+    int bufferBits;      // Número de bits pendientes (menos de 8 entre llamadas)
+    
+    BitWriter(unsigned char *out) : data(out), byteIndex(0), buffer(0), bufferBits(0) {
+    }
+    
+    /**
+     * Método para añadir bits y escribir los bytes que se completan
+     * @param value Bits a escribir, alineados a la derecha
+     * @param count Número de bits (como máximo 32)
+     */
+    void write(uint64_t value, int count) {
+      buffer = (buffer << count) | value;
+      bufferBits += count;
+      while (bufferBits >= 8) {
+        bufferBits -= 8;
+        data[byteIndex++] = (unsigned char)(buffer >> bufferBits);
+      }
+    }
+    
+    /**
+     * Método para añadir una palabra de hasta 64 bits en dos partes
+     * @param value Bits a escribir, alineados a la derecha
+     * @param count Número de bits
+     */
+    void writeWord(uint64_t value, int count) {
+      if (count > 32) {
+        write(value >> 32, count - 32);
+        value &= 0xFFFFFFFFULL;
+        count = 32;
+      }
+      write(value, count);
+    }
+    
+    /**
+     * Método para escribir el último byte incompleto, completado con ceros
+     */
+    void flush() {
+      if (bufferBits > 0) {
+        data[byteIndex++] = (unsigned char)(buffer << (8 - bufferBits));
+        bufferBits = 0;
+      }
+    }
+  };
+  
+public:
+  /**
+   * Método para codificar un bloque de K bits de datos
+   * @param data Bits de datos, alineados a la derecha
+   * @return Palabra código de N bits (posición 1 en el bit N - 1)
+   */
+  static uint64_t encodeWord(uint64_t data) {
+    uint64_t codeword = 0;
+    int dataLeft = K; // Bits de datos que quedan por colocar
+    
+    for (int i = 0; i < R; i++) {
+      // Bit de paridad de la posición 2^i
+      uint64_t parity = __builtin_popcountll(data & TABLES.parityMasks[i]) & 1;
+      codeword |= parity << (N - (1 << i));
+      
+      // Los datos de las posiciones 2^i + 1 a 2^(i+1) - 1 son consecutivos
+      int segment = (1 << i) - 1;
+      if (segment > 0) {
+        dataLeft -= segment;
+        uint64_t bits = (data >> dataLeft) & (((uint64_t)1 << segment) - 1);
+        codeword |= bits << (N - ((1 << (i + 1)) - 1));
+      }
+    }
+    return codeword;
+  }
+  
+  /**
+   * Método para decodificar una palabra código corrigiendo un posible error
+   * @param codeword Palabra código de N bits (posición 1 en el bit N - 1)
+   * @return Bits de datos, alineados a la derecha
+   */
+  static uint64_t decodeWord(uint64_t codeword) {
+    // El síndrome es directamente la posición del error
+    int syndrome = 0;
+    for (int i = 0; i < R; i++) {
+      syndrome |= (__builtin_popcountll(codeword & TABLES.syndromeMasks[i]) & 1) << i;
+    }
+    codeword ^= TABLES.errorMasks[syndrome];
+    
+    // Reunir los segmentos de datos
+    uint64_t data = 0;
+    for (int i = 1; i < R; i++) {
+      int segment = (1 << i) - 1;
+      data = (data << segment) | ((codeword >> (N - ((1 << (i + 1)) - 1))) & (((uint64_t)1 << segment) - 1));
+    }
+    return data;
+  }
+  
+  /**
+   * Método para calcular la longitud del mensaje codificado en bytes
+   * @param originalLength Longitud del mensaje original en bytes
+   * @return Longitud del mensaje codificado en bytes
+   */
+  static int getEncodedLength(int originalLength) {
+    int codewords = (originalLength * 8 + K - 1) / K; // Bloques de K bits, redondeo hacia arriba
+    return (codewords * N + 7) / 8;                   // Redondeo hacia arriba para obtener bytes
+  }
+  
+  /**
+   * Método para calcular cuántos bytes escribe decode. Puede ser algo mayor que la longitud
+   * original, porque el relleno del último bloque también se decodifica.
+   * @param encodedLength Longitud del mensaje codificado en bytes
+   * @return Longitud del mensaje decodificado en bytes
+   */
+  static int getDecodedLength(int encodedLength) {
+    int codewords = (encodedLength * 8) / N;
+    return (codewords * K) / 8;
+  }
+  
+  /**
+   * Método para codificar un mensaje
+   * @param in Vector binario de entrada empaquetado en unsigned char
+   * @param out Vector binario de salida empaquetado en unsigned char
+   * @param length Longitud del vector de entrada en bytes
+   */
+  static void encode(unsigned char *in, unsigned char *out, int length) {
+    int codewords = (length * 8 + K - 1) / K;
+    BitReader reader(in, length);
+    BitWriter writer(out);
+    
+    for (int c = 0; c < codewords; c++) {
+      writer.writeWord(encodeWord(reader.readWord(K)), N);
+    }
+    writer.flush();
+  }
+  
+  /**
+   * Método para decodificar un mensaje. Escribe getDecodedLength(length) bytes.
+   * @param in Vector binario de entrada empaquetado en unsigned char (mensaje codificado)
+   * @param out Vector binario de salida empaquetado en unsigned char (mensaje decodificado)
+   * @param length Longitud del vector de entrada en bytes
+   */
+  static void decode(unsigned char *in, unsigned char *out, int length) {
+    int codewords = (length * 8) / N;
+    BitReader reader(in, length);
+    BitWriter writer(out);
+    
+    for (int c = 0; c < codewords; c++) {
+      writer.writeWord(decodeWord(reader.readWord(N)), K);
+    }
+    // Los bits que no completan un byte son relleno y no se escriben
   }
 };
 
@@ -280,6 +1150,78 @@ void setup() {
   
   Serial.print("Decodificación correcta: ");
   Serial.println(correct ? "Sí" : "No");
+  
+  // Deshacer el error y borrar dos bits de la primera palabra código (posiciones 0 y 3)
+  coded[errorByteIndex] ^= (1 << errorBitPosition);
+  unsigned char erasures[codedLength];
+  for (int i = 0; i < codedLength; i++) {
+    erasures[i] = 0;
+  }
+  erasures[0] = 0b10010000;
+  coded[0] &= ~erasures[0];
+  
+  Serial.println("\nMensaje codificado con dos bits borrados (a 0):");
+  printBinaryVector(coded, codedLength);
+  Serial.println("Mapa de borrados:");
+  printBinaryVector(erasures, codedLength);
+  
+  int failures = hammingCode.decodeErasures(coded, erasures, decoded, codedLength);
+  
+  Serial.println("Mensaje decodificado (después de resolver los borrados):");
+  printBinaryVector(decoded, originalLength);
+  Serial.print("Palabras código no recuperadas: ");
+  Serial.println(failures);
+  
+  // Modo SECDED: cada palabra código ocupa un byte. Se introduce un error en la primera
+  // palabra (se corrige) y dos en la segunda (se detecta y se marca como no corregible)
+  Serial.println("\nHamming extendido (8,4) SECDED:");
+  HammingCode secdedCode(HammingCode::MODE_SECDED_8_4);
+  int secdedLength = secdedCode.getEncodedLength(originalLength);
+  unsigned char secdedCoded[secdedLength];
+  secdedCode.encode(original, secdedCoded, originalLength);
+  secdedCode.printInfo(original, secdedCoded, originalLength, secdedLength);
+  
+  secdedCoded[0] ^= 0b00100000;
+  secdedCoded[1] ^= 0b01000010;
+  Serial.println("Mensaje codificado con errores (1 en la primera palabra, 2 en la segunda):");
+  printBinaryVector(secdedCoded, secdedLength);
+  
+  unsigned char uncorrectable[secdedLength];
+  failures = secdedCode.decodeWithFlags(secdedCoded, decoded, uncorrectable, secdedLength);
+  
+  Serial.println("Mensaje decodificado:");
+  printBinaryVector(decoded, originalLength);
+  Serial.print("Palabras no corregibles: ");
+  for (int i = 0; i < secdedLength; i++) {
+    Serial.print(uncorrectable[i]);
+    Serial.print(" ");
+  }
+  Serial.println();
+  Serial.print("Total: ");
+  Serial.println(failures);
+  
+  // Hamming (15,11): el mismo mensaje ocupa menos que con (7,4). Se introduce un error en
+  // cada palabra código y se corrigen todos
+  Serial.println("\nHamming (15,11):");
+  int longLength = GeneralHammingCode<4>::getEncodedLength(originalLength);
+  unsigned char longCoded[longLength];
+  GeneralHammingCode<4>::encode(original, longCoded, originalLength);
+  Serial.print("Mensaje codificado (");
+  Serial.print(longLength);
+  Serial.println(" bytes):");
+  printBinaryVector(longCoded, longLength);
+  
+  longCoded[0] ^= 0b00010000;
+  longCoded[2] ^= 0b00000100;
+  Serial.println("Mensaje codificado con un error en cada palabra código:");
+  printBinaryVector(longCoded, longLength);
+  
+  unsigned char longDecoded[GeneralHammingCode<4>::getDecodedLength(longLength)];
+  GeneralHammingCode<4>::decode(longCoded, longDecoded, longLength);
+  Serial.println("Mensaje decodificado:");
+  printBinaryVector(longDecoded, originalLength);
+  Serial.print("Decodificación correcta: ");
+  Serial.println(memcmp(original, longDecoded, originalLength) == 0 ? "Sí" : "No");
 }
 
 void loop() {